@@ -3,19 +3,181 @@
 #include <exceptions.hpp>
 
 #include <algorithm>
+#include <cstring>
+#include <istream>
+#include <numeric>
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#   define DLX_HAS_HUGE_PAGES 1
+#   include <sys/mman.h>
+#endif
 
 namespace DLX
 {
+namespace
+{
+bool rowContainsColumn(MatrixElement const* element, ColumnHeader const* column_header)
+{
+    auto it = element;
+    do {
+        if(it->columnHeader == column_header) { return true; }
+        it = it->nextInRow;
+    } while(it != element);
+    return false;
+}
+
+std::size_t alignToBlock(std::size_t n)
+{
+    return (n + Storage::BlockAlignment - 1) & ~(Storage::BlockAlignment - 1);
+}
+
+// two rows conflict if selecting one of them removes the other
+bool rowsConflict(MatrixElement const* lhs, MatrixElement const* rhs)
+{
+    auto it = lhs;
+    do {
+        if(it->columnHeader->multiplicity == 1 && rowContainsColumn(rhs, it->columnHeader)) { return true; }
+        it = it->nextInRow;
+    } while(it != lhs);
+    return false;
+}
+}
+
+Storage::Block::Block(std::size_t block_size, bool use_huge_pages)
+    :memory(nullptr), size(block_size), used(0), isMapped(false)
+{
+#ifdef DLX_HAS_HUGE_PAGES
+    std::size_t const huge_page_size = 2 * 1024 * 1024;
+    if(use_huge_pages && block_size >= huge_page_size) {
+        size = (block_size + huge_page_size - 1) & ~(huge_page_size - 1);
+        void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mem != MAP_FAILED) {
+            // advisory only, the kernel may still back the mapping with regular pages
+            madvise(mem, size, MADV_HUGEPAGE);
+            memory = static_cast<char*>(mem);
+            isMapped = true;
+            return;
+        }
+        size = block_size;
+    }
+#else
+    (void)use_huge_pages;
+#endif
+    memory = static_cast<char*>(::operator new(size, std::align_val_t(Storage::BlockAlignment)));
+}
+
+Storage::Block::Block(Block&& rhs)
+    :memory(rhs.memory), size(rhs.size), used(rhs.used), isMapped(rhs.isMapped)
+{
+    rhs.memory = nullptr;
+}
+
+Storage::Block::~Block()
+{
+    if(!memory) { return; }
+#ifdef DLX_HAS_HUGE_PAGES
+    if(isMapped) { munmap(memory, size); return; }
+#endif
+    ::operator delete(memory, std::align_val_t(Storage::BlockAlignment));
+}
+
+void Storage::reserve(std::size_t bytes)
+{
+    if(m_storage[m_currentBlock].size - m_offset < bytes) { nextBlock(bytes); }
+}
+
+void Storage::reset()
+{
+    m_currentBlock = 0;
+    m_offset = 0;
+    m_bytesWasted = 0;
+}
+
+void Storage::nextBlock(std::size_t min_size)
+{
+    m_storage[m_currentBlock].used = m_offset;
+    m_bytesWasted += m_storage[m_currentBlock].size - m_offset;
+    m_offset = 0;
+    // reuse blocks left over from before a reset if they are large enough
+    while(++m_currentBlock < m_storage.size())
+    {
+        if(m_storage[m_currentBlock].size >= min_size) { return; }
+        m_storage[m_currentBlock].used = 0;
+        m_bytesWasted += m_storage[m_currentBlock].size;
+    }
+    m_storage.push_back(Block(std::max(min_size, m_blockSize), m_useHugePages));
+}
+
+std::size_t Storage::getCopySize() const
+{
+    std::size_t ret = 0;
+    for(std::size_t i=0; i<m_currentBlock; ++i) { ret += alignToBlock(m_storage[i].used); }
+    return ret + alignToBlock(m_offset);
+}
+
+Storage::Relocation Storage::copyFrom(Storage const& source)
+{
+    auto const used = [&source](std::size_t i) {
+        return (i == source.m_currentBlock) ? source.m_offset : source.m_storage[i].used;
+    };
+
+    reset();
+    reserve(source.getCopySize());
+    // block starts are aligned for every type, so copying to aligned offsets preserves the alignment of all objects
+    m_offset = alignToBlock(m_offset);
+    Relocation ret;
+    for(std::size_t i=0; i<=source.m_currentBlock; ++i)
+    {
+        auto const n = used(i);
+        if(n == 0) { continue; }
+        char* destination = m_storage[m_currentBlock].memory + m_offset;
+        std::memcpy(destination, source.m_storage[i].memory, n);
+        ret.m_ranges.push_back(Relocation::Range{ source.m_storage[i].memory, destination });
+        m_offset = alignToBlock(m_offset + n);
+    }
+    std::sort(ret.m_ranges.begin(), ret.m_ranges.end(),
+              [](Relocation::Range const& lhs, Relocation::Range const& rhs) { return lhs.oldBegin < rhs.oldBegin; });
+    return ret;
+}
+
 Matrix::Matrix(int nColumns)
     :m_nColumns(nColumns), m_nRows(0)
+{
+    initializeHeaders();
+}
+
+Matrix::Matrix(Uninitialized, int nColumns, std::size_t capacity, bool use_huge_pages)
+    :m_nColumns(nColumns), m_nRows(0), m_storage(capacity, use_huge_pages), m_matrixHeader(nullptr)
+{}
+
+Matrix::Matrix(int nColumns, int nRows, std::size_t nNonZeros, bool use_huge_pages)
+    :m_nColumns(nColumns), m_nRows(0), m_storage(requiredBytes(nColumns, nNonZeros), use_huge_pages)
+{
+    initializeHeaders();
+    reserveRows(nRows);
+}
+
+std::size_t Matrix::requiredBytes(int nColumns, std::size_t nNonZeros)
+{
+    return Storage::requiredBytes<Header>(1) + Storage::requiredBytes<ColumnHeader>(nColumns) +
+           Storage::requiredBytes<MatrixElement>(nNonZeros);
+}
+
+void Matrix::initializeHeaders()
 {
     m_matrixHeader = m_storage.allocate<Header>();
+    m_occupiedColumns.assign((m_nColumns + 63) / 64, 0);
 
+    m_columnHeaders.reserve(m_nColumns);
     ColumnHeaderListElement* it = m_matrixHeader;
     for(int i=0; i<m_nColumns; ++i)
     {
         auto column_header = m_storage.allocate<ColumnHeader>();
+        m_columnHeaders.push_back(column_header);
         column_header->columnIndex = i;
         column_header->previousInColumn = column_header->nextInColumn = column_header;
         it->nextInHeaderList = column_header;
@@ -26,38 +188,73 @@ Matrix::Matrix(int nColumns)
     m_matrixHeader->previousInHeaderList = it;
 }
 
+void Matrix::reset(int nColumns, int nRows, std::size_t nNonZeros)
+{
+    m_storage.reset();
+    m_storage.reserve(requiredBytes(nColumns, nNonZeros));
+    m_nColumns = nColumns;
+    m_nRows = 0;
+    m_columnHeaders.clear();
+    m_rowHeaders.clear();
+    m_rowElements.clear();
+    m_deactivatedColumns.clear();
+    m_selectedRows.clear();
+    m_statistics = SearchStatistics();
+    initializeHeaders();
+    reserveRows(nRows);
+}
+
+void Matrix::reserveRows(int nRows)
+{
+    m_rowHeaders.reserve(nRows);
+    m_rowElements.reserve(nRows);
+}
+
 void Matrix::addRow(RowHeader const& row_header, std::vector<int> const& occupied_fields)
 {
+    addRow(row_header, occupied_fields.data(), static_cast<int>(occupied_fields.size()));
+}
+
+void Matrix::addRow(RowHeader const& row_header, int const* occupied_fields, int n_occupied)
+{
+    if(!std::is_sorted(occupied_fields, occupied_fields + n_occupied)) {
+        std::vector<int> sorted_fields(occupied_fields, occupied_fields + n_occupied);
+        std::sort(begin(sorted_fields), end(sorted_fields));
+        addRow(row_header, sorted_fields.data(), n_occupied);
+        return;
+    }
+
+    // the elements of a row are kept contiguous, so that an element's position in its row can be computed
+    m_storage.reserve(Storage::requiredBytes<MatrixElement>(n_occupied));
     MatrixElement* row_it = nullptr;
     MatrixElement* first_in_row = nullptr;
-    auto column_header_it = static_cast<ColumnHeader*>(m_matrixHeader->nextInHeaderList);
-    for(int i=0; i<m_nColumns; ++i)
+    for(int i=0; i<n_occupied; ++i)
     {
-        if(std::find(begin(occupied_fields), end(occupied_fields), i) != end(occupied_fields))
-        {
-            column_header_it->columnCount += 1;
-            auto new_entry = m_storage.allocate<MatrixElement>();
-            new_entry->rowIndex = m_nRows;
+        int const column_index = occupied_fields[i];
+        if(column_index < 0 || column_index >= m_nColumns) { PROTOCOL_VIOLATION("Invalid column index"); }
+        if(i > 0 && column_index == occupied_fields[i-1]) { continue; }
+        auto column_header = m_columnHeaders[column_index];
+        column_header->columnCount += 1;
+        auto new_entry = m_storage.allocate<MatrixElement>();
+        new_entry->rowIndex = m_nRows;
 
-            // link in column list
-            {
-                new_entry->columnHeader = column_header_it;
-                auto previous_element = column_header_it->previousInColumn;
-                auto next_element = column_header_it;
-                previous_element->nextInColumn = new_entry;
-                new_entry->previousInColumn = previous_element;
-                next_element->previousInColumn = new_entry;
-                new_entry->nextInColumn = next_element;
-            }
+        // link in column list
+        {
+            new_entry->columnHeader = column_header;
+            auto previous_element = column_header->previousInColumn;
+            auto next_element = column_header;
+            previous_element->nextInColumn = new_entry;
+            new_entry->previousInColumn = previous_element;
+            next_element->previousInColumn = new_entry;
+            new_entry->nextInColumn = next_element;
+        }
 
-            // link in row list
-            {
-                new_entry->previousInRow = row_it;
-                if(row_it) { row_it->nextInRow = new_entry; } else { first_in_row = new_entry; }
-                row_it = new_entry;
-            }
+        // link in row list
+        {
+            new_entry->previousInRow = row_it;
+            if(row_it) { row_it->nextInRow = new_entry; } else { first_in_row = new_entry; }
+            row_it = new_entry;
         }
-        column_header_it = static_cast<ColumnHeader*>(column_header_it->nextInHeaderList);
     }
     // link row list boundaries
     if(row_it) {
@@ -65,20 +262,20 @@ void Matrix::addRow(RowHeader const& row_header, std::vector<int> const& occupie
         first_in_row->previousInRow = row_it;
     }
     m_rowHeaders.push_back(row_header);
+    m_rowElements.push_back(first_in_row);
     ++m_nRows;
 }
 
 bool Matrix::isOccupied(int row, int col) const
 {
-    auto column_header_it = static_cast<ColumnHeader*>(m_matrixHeader->nextInHeaderList);
-    for(int i=0; i<col; ++i) { column_header_it = static_cast<ColumnHeader*>(column_header_it->nextInHeaderList); }
-    if(column_header_it->columnIndex != col) { PROTOCOL_VIOLATION("Invalid column index"); }
+    if(col < 0 || col >= m_nColumns) { PROTOCOL_VIOLATION("Invalid column index"); }
+    auto column_header_it = m_columnHeaders[col];
 
-    auto column_it = column_header_it->nextInColumn;
-    do {
+    for(auto column_it = column_header_it->nextInColumn; column_it != column_header_it;
+        column_it = column_it->nextInColumn)
+    {
         if(static_cast<MatrixElement*>(column_it)->rowIndex == row) { return true; }
-        column_it = column_it->nextInColumn;
-    } while(column_it != column_header_it);
+    }
     return false;
 }
 
@@ -96,28 +293,424 @@ void Matrix::printRow(int rowIndex, std::ostream& os, int pieceCount, int field_
                       RowHeaderUserDataPrinter const& pretty_printer, bool compact) const
 {
     if(pretty_printer) { pretty_printer(os, m_rowHeaders[rowIndex].UserData); }
+    std::vector<int> columns;
+    getRowColumns(rowIndex, columns);
+    auto column_it = columns.begin();
     for(int j=0; j<m_nColumns; ++j)
     {
         if(!compact && ((j >= pieceCount)) && ((j - pieceCount) % field_width == 0)) { os << '\n'; }
-        os << (isOccupied(rowIndex, j) ? '1' : '0') << ' ';
+        bool const is_occupied = (column_it != columns.end()) && (*column_it == j);
+        if(is_occupied) { ++column_it; }
+        os << (is_occupied ? '1' : '0') << ' ';
     }
 }
 
 Matrix Matrix::clone() const
 {
-    Matrix ret(m_nColumns);
-    std::vector<int> occupied_fields;
+    // the copy fits into the first block of the new storage, so no block is allocated in vain
+    Matrix ret(Uninitialized(), m_nColumns, m_storage.getCopySize(), m_storage.usesHugePages());
+    auto const relocate = ret.m_storage.copyFrom(m_storage);
+    ret.m_nRows = m_nRows;
+
+    // the header of the matrix
+    ret.m_matrixHeader = relocate(m_matrixHeader);
+    ret.m_matrixHeader->nextInHeaderList = relocate(m_matrixHeader->nextInHeaderList);
+    ret.m_matrixHeader->previousInHeaderList = relocate(m_matrixHeader->previousInHeaderList);
+
+    // column headers
+    ret.m_columnHeaders.reserve(m_columnHeaders.size());
+    for(auto column_header : m_columnHeaders)
+    {
+        auto new_header = relocate(column_header);
+        new_header->nextInColumn = relocate(column_header->nextInColumn);
+        new_header->previousInColumn = relocate(column_header->previousInColumn);
+        new_header->nextInHeaderList = relocate(column_header->nextInHeaderList);
+        new_header->previousInHeaderList = relocate(column_header->previousInHeaderList);
+        ret.m_columnHeaders.push_back(new_header);
+    }
+
+    // matrix elements, row by row
+    ret.m_rowElements.reserve(m_rowElements.size());
+    for(auto first_in_row : m_rowElements)
+    {
+        auto it = first_in_row;
+        if(it) {
+            do {
+                auto new_element = relocate(it);
+                new_element->nextInColumn = relocate(it->nextInColumn);
+                new_element->previousInColumn = relocate(it->previousInColumn);
+                new_element->nextInRow = relocate(it->nextInRow);
+                new_element->previousInRow = relocate(it->previousInRow);
+                new_element->columnHeader = relocate(it->columnHeader);
+                it = it->nextInRow;
+            } while(it != first_in_row);
+        }
+        ret.m_rowElements.push_back(relocate(first_in_row));
+    }
+
+    ret.m_rowHeaders = m_rowHeaders;
+    ret.m_deactivatedColumns.reserve(m_deactivatedColumns.size());
+    for(auto column_header : m_deactivatedColumns) { ret.m_deactivatedColumns.push_back(relocate(column_header)); }
+    ret.m_selectedRows = m_selectedRows;
+    ret.m_statistics = m_statistics;
+    ret.m_occupiedColumns = m_occupiedColumns;
+    ret.m_pruningHook = m_pruningHook;
+    ret.m_branchingHook = m_branchingHook;
+    return ret;
+}
+
+void Matrix::optimizeLayout(int firstKeyColumn)
+{
+    if(firstKeyColumn < 0 || firstKeyColumn > m_nColumns) { PROTOCOL_VIOLATION("Invalid column index"); }
+    // the columns of a row are in ascending order, so the key is the first one past firstKeyColumn
+    std::vector<int> row_length(m_nRows, 0);
+    std::vector<int> row_key(m_nRows, m_nColumns);
+    std::size_t n_elements = 0;
     for(int i=0; i<m_nRows; ++i)
     {
-        occupied_fields.clear();
-        for(int j=0; j<m_nColumns; ++j)
+        for(auto it = m_rowElements[i]; it; it = (it->nextInRow == m_rowElements[i]) ? nullptr : it->nextInRow)
+        {
+            ++row_length[i];
+            if(row_key[i] == m_nColumns && it->columnHeader->columnIndex >= firstKeyColumn) {
+                row_key[i] = it->columnHeader->columnIndex;
+            }
+        }
+        n_elements += row_length[i];
+    }
+    std::vector<int> order(m_nRows);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&row_key](int lhs, int rhs) { return row_key[lhs] < row_key[rhs]; });
+
+    // rows stay contiguous, so nodes are mapped by their row and their position in it
+    Storage storage(requiredBytes(m_nColumns, n_elements), m_storage.usesHugePages());
+    auto const new_header = storage.allocate<Header>();
+    std::vector<ColumnHeader*> new_column_headers(m_nColumns);
+    for(int i=0; i<m_nColumns; ++i) { new_column_headers[i] = storage.allocate<ColumnHeader>(); }
+    std::vector<MatrixElement*> new_row_elements(m_nRows, nullptr);
+    for(auto const row : order)
+    {
+        storage.reserve(Storage::requiredBytes<MatrixElement>(row_length[row]));
+        for(int j=0; j<row_length[row]; ++j)
+        {
+            auto const element = storage.allocate<MatrixElement>();
+            if(j == 0) { new_row_elements[row] = element; }
+        }
+    }
+
+    auto const list_node = [&](ColumnHeaderListElement const* e) -> ColumnHeaderListElement* {
+        if(e == m_matrixHeader) { return new_header; }
+        return new_column_headers[static_cast<ColumnHeader const*>(e)->columnIndex];
+    };
+    auto const element_node = [&](MatrixElement const* e) {
+        return new_row_elements[e->rowIndex] + (e - m_rowElements[e->rowIndex]);
+    };
+    auto const column_node = [&](ColumnElement const* e, ColumnHeader const* column_header) -> ColumnElement* {
+        if(e == column_header) { return new_column_headers[column_header->columnIndex]; }
+        return element_node(static_cast<MatrixElement const*>(e));
+    };
+
+    *new_header = *m_matrixHeader;
+    new_header->nextInHeaderList = list_node(m_matrixHeader->nextInHeaderList);
+    new_header->previousInHeaderList = list_node(m_matrixHeader->previousInHeaderList);
+    for(int i=0; i<m_nColumns; ++i)
+    {
+        auto const column_header = m_columnHeaders[i];
+        auto const new_column_header = new_column_headers[i];
+        *new_column_header = *column_header;
+        new_column_header->nextInColumn = column_node(column_header->nextInColumn, column_header);
+        new_column_header->previousInColumn = column_node(column_header->previousInColumn, column_header);
+        new_column_header->nextInHeaderList = list_node(column_header->nextInHeaderList);
+        new_column_header->previousInHeaderList = list_node(column_header->previousInHeaderList);
+    }
+    for(auto first_in_row : m_rowElements)
+    {
+        for(auto it = first_in_row; it; it = (it->nextInRow == first_in_row) ? nullptr : it->nextInRow)
         {
-            if(isOccupied(i, j)) { occupied_fields.push_back(j); }
+            auto const new_element = element_node(it);
+            *new_element = *it;
+            new_element->nextInColumn = column_node(it->nextInColumn, it->columnHeader);
+            new_element->previousInColumn = column_node(it->previousInColumn, it->columnHeader);
+            new_element->nextInRow = element_node(it->nextInRow);
+            new_element->previousInRow = element_node(it->previousInRow);
+            new_element->columnHeader = new_column_headers[it->columnHeader->columnIndex];
         }
-        ret.addRow(m_rowHeaders[i], occupied_fields);
     }
+
+    for(auto& column_header : m_deactivatedColumns) { column_header = new_column_headers[column_header->columnIndex]; }
+    m_matrixHeader = new_header;
+    m_columnHeaders.swap(new_column_headers);
+    m_rowElements.swap(new_row_elements);
+    m_storage = std::move(storage);
+}
+
+namespace
+{
+std::uint32_t const SerializationMagic = 0x584c4432;     // "DLX2"
+
+template<typename T>
+void writeValue(std::ostream& os, T const& v)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as raw bytes");
+    os.write(reinterpret_cast<char const*>(&v), sizeof(T));
+}
+
+template<typename T>
+T readValue(std::istream& is)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as raw bytes");
+    T ret;
+    if(!is.read(reinterpret_cast<char*>(&ret), sizeof(T))) { throw std::runtime_error("Unexpected end of matrix data"); }
     return ret;
 }
+}
+
+/* Nodes are identified by index in the serialized format: 0 is the matrix header, 1 to nColumns are the
+ * column headers, followed by the matrix elements in row order.
+ */
+void Matrix::serialize(std::ostream& os) const
+{
+    std::vector<std::int32_t> row_start(m_nRows + 1);
+    row_start[0] = 1 + m_nColumns;
+    for(int i=0; i<m_nRows; ++i)
+    {
+        int n = 0;
+        if(auto it = m_rowElements[i]) { do { ++n; it = it->nextInRow; } while(it != m_rowElements[i]); }
+        row_start[i + 1] = row_start[i] + n;
+    }
+    // column lists contain the elements of the column and its header, header lists only headers
+    auto const column_node_index = [&](ColumnElement const* e, ColumnHeader const* column_header) -> std::int32_t {
+        if(e == column_header) { return 1 + column_header->columnIndex; }
+        auto const el = static_cast<MatrixElement const*>(e);
+        return row_start[el->rowIndex] + static_cast<std::int32_t>(el - m_rowElements[el->rowIndex]);
+    };
+    auto const list_node_index = [&](ColumnHeaderListElement const* e) -> std::int32_t {
+        return (e == m_matrixHeader) ? 0 : 1 + static_cast<ColumnHeader const*>(e)->columnIndex;
+    };
+
+    writeValue(os, SerializationMagic);
+    writeValue<std::int32_t>(os, m_nColumns);
+    writeValue<std::int32_t>(os, m_nRows);
+    // static structure: the columns of each row
+    for(int i=0; i<m_nRows; ++i)
+    {
+        writeValue<std::int32_t>(os, row_start[i + 1] - row_start[i]);
+        for(auto it = m_rowElements[i]; it; it = (it->nextInRow == m_rowElements[i]) ? nullptr : it->nextInRow)
+        {
+            writeValue<std::int32_t>(os, it->columnHeader->columnIndex);
+        }
+    }
+    // dynamic state: all links that are modified by covering and uncovering
+    writeValue(os, list_node_index(m_matrixHeader->nextInHeaderList));
+    writeValue(os, list_node_index(m_matrixHeader->previousInHeaderList));
+    for(auto column_header : m_columnHeaders)
+    {
+        writeValue<std::int32_t>(os, column_header->columnCount);
+        writeValue<std::int32_t>(os, column_header->multiplicity);
+        writeValue(os, column_node_index(column_header->nextInColumn, column_header));
+        writeValue(os, column_node_index(column_header->previousInColumn, column_header));
+        writeValue(os, list_node_index(column_header->nextInHeaderList));
+        writeValue(os, list_node_index(column_header->previousInHeaderList));
+    }
+    for(auto first_in_row : m_rowElements)
+    {
+        for(auto it = first_in_row; it; it = (it->nextInRow == first_in_row) ? nullptr : it->nextInRow)
+        {
+            writeValue(os, column_node_index(it->nextInColumn, it->columnHeader));
+            writeValue(os, column_node_index(it->previousInColumn, it->columnHeader));
+        }
+    }
+    writeValue<std::int32_t>(os, static_cast<std::int32_t>(m_deactivatedColumns.size()));
+    for(auto column_header : m_deactivatedColumns) { writeValue<std::int32_t>(os, column_header->columnIndex); }
+    writeValue<std::int32_t>(os, static_cast<std::int32_t>(m_selectedRows.size()));
+    for(auto row : m_selectedRows) { writeValue<std::int32_t>(os, row); }
+    writeValue(os, m_statistics.nodes);
+    writeValue(os, m_statistics.linkUpdates);
+    writeValue(os, m_statistics.solutions);
+    writeValue<std::int32_t>(os, static_cast<std::int32_t>(m_statistics.nodesPerDepth.size()));
+    for(auto const n : m_statistics.nodesPerDepth) { writeValue(os, n); }
+}
+
+Matrix Matrix::deserialize(std::istream& is, std::vector<RowHeader> const& row_headers)
+{
+    if(readValue<std::uint32_t>(is) != SerializationMagic) { throw std::runtime_error("Invalid matrix data"); }
+    auto const n_columns = readValue<std::int32_t>(is);
+    auto const n_rows = readValue<std::int32_t>(is);
+    if(n_columns < 0 || n_rows < 0) { throw std::runtime_error("Invalid matrix dimensions"); }
+    if(!row_headers.empty() && static_cast<int>(row_headers.size()) != n_rows) {
+        PROTOCOL_VIOLATION("Number of row headers does not match matrix");
+    }
+
+    std::vector<std::int32_t> columns;
+    std::vector<std::int32_t> row_start(1, 0);
+    std::vector<int> column_size(n_columns, 0);
+    for(int i=0; i<n_rows; ++i)
+    {
+        auto const n = readValue<std::int32_t>(is);
+        if(n < 0 || n > n_columns) { throw std::runtime_error("Invalid row size"); }
+        for(int j=0; j<n; ++j)
+        {
+            // addRow() would sort and merge the columns, which breaks the mapping of node indices to rows
+            auto const column = readValue<std::int32_t>(is);
+            if(column < 0 || column >= n_columns || (j > 0 && column <= columns.back())) {
+                throw std::runtime_error("Invalid column index in row");
+            }
+            columns.push_back(column);
+            ++column_size[column];
+        }
+        row_start.push_back(static_cast<std::int32_t>(columns.size()));
+    }
+
+    Matrix ret(n_columns, n_rows, columns.size());
+    for(int i=0; i<n_rows; ++i)
+    {
+        ret.addRow(row_headers.empty() ? RowHeader() : row_headers[i], columns.data() + row_start[i],
+                   row_start[i + 1] - row_start[i]);
+    }
+
+    auto const n_nodes = 1 + n_columns + static_cast<std::int32_t>(columns.size());
+    auto const node = [&](std::int32_t index) -> ColumnElement* {
+        if(index < 0 || index >= n_nodes) { throw std::runtime_error("Invalid node index"); }
+        if(index == 0) { return ret.m_matrixHeader; }
+        if(index <= n_columns) { return ret.m_columnHeaders[index - 1]; }
+        index -= 1 + n_columns;
+        auto const row = static_cast<int>(std::upper_bound(row_start.begin(), row_start.end(), index) - row_start.begin()) - 1;
+        return ret.m_rowElements[row] + (index - row_start[row]);
+    };
+    auto const list_node = [&](std::int32_t index) -> ColumnHeaderListElement* {
+        if(index > n_columns) { throw std::runtime_error("Invalid header list index"); }
+        return static_cast<ColumnHeaderListElement*>(node(index));
+    };
+    // a column list only contains the header and the elements of its column
+    auto const column_node = [&](std::int32_t index, ColumnHeader const* column_header) -> ColumnElement* {
+        auto const e = node(index);
+        bool const in_column = (index > n_columns) ? static_cast<MatrixElement*>(e)->columnHeader == column_header
+                                                   : e == column_header;
+        if(!in_column) { throw std::runtime_error("Invalid column list index"); }
+        return e;
+    };
+
+    ret.m_matrixHeader->nextInHeaderList = list_node(readValue<std::int32_t>(is));
+    ret.m_matrixHeader->previousInHeaderList = list_node(readValue<std::int32_t>(is));
+    for(auto column_header : ret.m_columnHeaders)
+    {
+        column_header->columnCount = readValue<std::int32_t>(is);
+        column_header->multiplicity = readValue<std::int32_t>(is);
+        if(column_header->multiplicity < 0) { throw std::runtime_error("Invalid column multiplicity"); }
+        column_header->nextInColumn = column_node(readValue<std::int32_t>(is), column_header);
+        column_header->previousInColumn = column_node(readValue<std::int32_t>(is), column_header);
+        column_header->nextInHeaderList = list_node(readValue<std::int32_t>(is));
+        column_header->previousInHeaderList = list_node(readValue<std::int32_t>(is));
+    }
+    for(auto first_in_row : ret.m_rowElements)
+    {
+        for(auto it = first_in_row; it; it = (it->nextInRow == first_in_row) ? nullptr : it->nextInRow)
+        {
+            it->nextInColumn = column_node(readValue<std::int32_t>(is), it->columnHeader);
+            it->previousInColumn = column_node(readValue<std::int32_t>(is), it->columnHeader);
+        }
+    }
+
+    // the lists that the search walks must be closed and doubly linked, and uncoverColumn() walks
+    // exactly columnCount elements of a column
+    int header_list_length = 0;
+    for(ColumnHeaderListElement const* it = ret.m_matrixHeader; it->nextInHeaderList != ret.m_matrixHeader;
+        it = it->nextInHeaderList)
+    {
+        if(it->nextInHeaderList->previousInHeaderList != it || ++header_list_length > n_columns) {
+            throw std::runtime_error("Inconsistent header list");
+        }
+    }
+    if(ret.m_matrixHeader->previousInHeaderList->nextInHeaderList != ret.m_matrixHeader) {
+        throw std::runtime_error("Inconsistent header list");
+    }
+    for(int i=0; i<n_columns; ++i)
+    {
+        auto const column_header = ret.m_columnHeaders[i];
+        int length = 0;
+        for(ColumnElement const* it = column_header; it->nextInColumn != column_header; it = it->nextInColumn)
+        {
+            if(it->nextInColumn->previousInColumn != it || ++length > column_size[i]) {
+                throw std::runtime_error("Inconsistent column list");
+            }
+        }
+        if(column_header->previousInColumn->nextInColumn != column_header || length != column_header->columnCount) {
+            throw std::runtime_error("Inconsistent column list");
+        }
+    }
+
+    auto const n_deactivated = readValue<std::int32_t>(is);
+    if(n_deactivated < 0 || n_deactivated > n_columns) { throw std::runtime_error("Invalid deactivated columns"); }
+    for(int i=0; i<n_deactivated; ++i)
+    {
+        auto const column = readValue<std::int32_t>(is);
+        if(column < 0 || column >= n_columns ||
+           std::find(ret.m_deactivatedColumns.begin(), ret.m_deactivatedColumns.end(), ret.m_columnHeaders[column]) !=
+               ret.m_deactivatedColumns.end())
+        {
+            throw std::runtime_error("Invalid deactivated column");
+        }
+        ret.m_deactivatedColumns.push_back(ret.m_columnHeaders[column]);
+    }
+    // outside of a search, exactly the used up and the deactivated columns are occupied
+    for(auto column_header : ret.m_columnHeaders)
+    {
+        if(column_header->multiplicity == 0) { ret.setOccupied(column_header); }
+    }
+    for(auto column_header : ret.m_deactivatedColumns) { ret.setOccupied(column_header); }
+    auto const n_selected = readValue<std::int32_t>(is);
+    for(int i=0; i<n_selected; ++i)
+    {
+        auto const row = readValue<std::int32_t>(is);
+        if(row < 0 || row >= n_rows) { throw std::runtime_error("Invalid selected row"); }
+        ret.m_selectedRows.push_back(row);
+    }
+    ret.m_statistics.nodes = readValue<std::uint64_t>(is);
+    ret.m_statistics.linkUpdates = readValue<std::uint64_t>(is);
+    ret.m_statistics.solutions = readValue<std::uint64_t>(is);
+    auto const n_depths = readValue<std::int32_t>(is);
+    if(n_depths < 0) { throw std::runtime_error("Invalid search statistics"); }
+    for(int i=0; i<n_depths; ++i) { ret.m_statistics.nodesPerDepth.push_back(readValue<std::uint64_t>(is)); }
+    if(is.peek() != std::char_traits<char>::eof()) { throw std::runtime_error("Unexpected data after matrix"); }
+    return ret;
+}
+
+void Matrix::selectRow(int rowIndex)
+{
+    if(rowIndex < 0 || rowIndex >= m_nRows) { PROTOCOL_VIOLATION("Invalid row index"); }
+    auto const first_in_row = m_rowElements[rowIndex];
+    if(!first_in_row) { PROTOCOL_VIOLATION("Cannot select an empty row"); }
+    auto it = first_in_row;
+    do {
+        // a row that is no longer linked into its column has been removed by a previous selection
+        if(it->previousInColumn->nextInColumn != it) { PROTOCOL_VIOLATION("Row conflicts with selected rows"); }
+        // covering a column leaves its own rows linked, so check the column itself as well
+        auto const column = it->columnHeader->columnIndex;
+        if(it->columnHeader->multiplicity <= 0 || ((m_occupiedColumns[column / 64] >> (column % 64)) & 1))
+        {
+            PROTOCOL_VIOLATION("Row covers an occupied column");
+        }
+        it = it->nextInRow;
+    } while(it != first_in_row);
+
+    it = first_in_row;
+    do {
+        selectColumn(it->columnHeader);
+        it = it->nextInRow;
+    } while(it != first_in_row);
+    m_selectedRows.push_back(rowIndex);
+}
+
+void Matrix::unselectRow()
+{
+    if(m_selectedRows.empty()) { PROTOCOL_VIOLATION("No row selected"); }
+    auto const first_in_row = m_rowElements[m_selectedRows.back()];
+    auto it = first_in_row->previousInRow;
+    do {
+        deselectColumn(it->columnHeader);
+        it = it->previousInRow;
+    } while(it != first_in_row->previousInRow);
+    m_selectedRows.pop_back();
+}
 
 ColumnHeader* Matrix::getHeaderWithFewestOccupants()
 {
@@ -142,6 +735,7 @@ void Matrix::coverColumn(ColumnHeader* column_header)
     column_header->previousInHeaderList->nextInHeaderList = column_header->nextInHeaderList;
 
     // traverse column elements
+    std::uint64_t link_updates = 1;
     auto column_it = column_header->nextInColumn;
     for(int i=0; i<column_header->columnCount; ++i)
     {
@@ -152,14 +746,17 @@ void Matrix::coverColumn(ColumnHeader* column_header)
             it->nextInColumn->previousInColumn = it->previousInColumn;
             it->previousInColumn->nextInColumn = it->nextInColumn;
             it->columnHeader->columnCount -= 1;
+            ++link_updates;
         }
         column_it = column_it->nextInColumn;
     }
+    m_statistics.linkUpdates += link_updates;
 }
 
 void Matrix::uncoverColumn(ColumnHeader* column_header)
 {
     // traverse column elements
+    std::uint64_t link_updates = 1;
     auto column_it = column_header->previousInColumn;
     for(int i=0; i<column_header->columnCount; ++i)
     {
@@ -170,57 +767,233 @@ void Matrix::uncoverColumn(ColumnHeader* column_header)
             it->nextInColumn->previousInColumn = it;
             it->previousInColumn->nextInColumn = it;
             it->columnHeader->columnCount += 1;
+            ++link_updates;
         }
         column_it = column_it->previousInColumn;
     }
+    m_statistics.linkUpdates += link_updates;
 
     // relink column header
     column_header->nextInHeaderList->previousInHeaderList = column_header;
     column_header->previousInHeaderList->nextInHeaderList = column_header;
 }
 
+void Matrix::selectColumn(ColumnHeader* column_header)
+{
+    // primary columns have a multiplicity of one and are covered right away
+    if(--column_header->multiplicity == 0) {
+        coverColumn(column_header);
+        setOccupied(column_header);
+    }
+}
+
+void Matrix::deselectColumn(ColumnHeader* column_header)
+{
+    if(column_header->multiplicity++ == 0) {
+        clearOccupied(column_header);
+        uncoverColumn(column_header);
+    }
+}
+
+void Matrix::removeRow(MatrixElement* element)
+{
+    auto it = element;
+    do {
+        it->nextInColumn->previousInColumn = it->previousInColumn;
+        it->previousInColumn->nextInColumn = it->nextInColumn;
+        it->columnHeader->columnCount -= 1;
+        it = it->nextInRow;
+    } while(it != element);
+}
+
+PreprocessStatistics Matrix::preprocess()
+{
+    PreprocessStatistics ret;
+    auto const count_primary_columns = [this]() {
+        int count = 0;
+        for(auto it = m_matrixHeader->nextInHeaderList; it != m_matrixHeader; it = it->nextInHeaderList) { ++count; }
+        return count;
+    };
+    int const primary_columns = count_primary_columns();
+    std::vector<char> is_candidate(m_nRows, 0);
+    for(bool changed = true; changed; )
+    {
+        changed = false;
+        ++ret.passes;
+
+        // forced rows; selecting a row changes the header list, so start over after each one
+        for(bool forced = true; forced; )
+        {
+            forced = false;
+            for(auto it = m_matrixHeader->nextInHeaderList; it != m_matrixHeader; it = it->nextInHeaderList)
+            {
+                auto const column_header = static_cast<ColumnHeader*>(it);
+                if(column_header->columnCount == 0) {
+                    ret.infeasible = true;
+                    ret.removedColumns = primary_columns - count_primary_columns();
+                    return ret;
+                }
+                if(column_header->columnCount == 1) {
+                    selectRow(static_cast<MatrixElement*>(column_header->nextInColumn)->rowIndex);
+                    ++ret.forcedRows;
+                    forced = changed = true;
+                    break;
+                }
+            }
+        }
+
+        for(auto it = m_matrixHeader->nextInHeaderList; it != m_matrixHeader; it = it->nextInHeaderList)
+        {
+            auto const column_header = static_cast<ColumnHeader*>(it);
+            if(removeDominatedRows(column_header, ret)) { changed = true; }
+            if(removeDeadRows(column_header, is_candidate, ret)) { changed = true; }
+            if(column_header->columnCount == 0) {
+                ret.infeasible = true;
+                ret.removedColumns = primary_columns - count_primary_columns();
+                return ret;
+            }
+        }
+    }
+    ret.removedColumns = primary_columns - count_primary_columns();
+    return ret;
+}
+
+bool Matrix::removeDominatedRows(ColumnHeader* column_header, PreprocessStatistics& statistics)
+{
+    if(column_header->columnCount == 0) { return false; }
+    // every column containing all rows of this column is one of the columns of its first row
+    auto const first = static_cast<MatrixElement*>(column_header->nextInColumn);
+    bool removed = false;
+    for(auto e = first->nextInRow; e != first; e = e->nextInRow)
+    {
+        auto const other = e->columnHeader;
+        if(other->multiplicity != 1 || other->columnCount <= column_header->columnCount) { continue; }
+        bool is_subset = true;
+        auto row_it = first->nextInColumn;
+        for(int i=1; i<column_header->columnCount && is_subset; ++i, row_it = row_it->nextInColumn)
+        {
+            is_subset = rowContainsColumn(static_cast<MatrixElement*>(row_it), other);
+        }
+        if(!is_subset) { continue; }
+        // covering this column also covers the other one, so no row can cover the other column alone
+        std::vector<MatrixElement*> dominated;
+        auto other_it = other->nextInColumn;
+        for(int i=0; i<other->columnCount; ++i, other_it = other_it->nextInColumn)
+        {
+            auto const element = static_cast<MatrixElement*>(other_it);
+            if(!rowContainsColumn(element, column_header)) { dominated.push_back(element); }
+        }
+        for(auto element : dominated) { removeRow(element); }
+        statistics.removedRows += static_cast<int>(dominated.size());
+        removed = removed || !dominated.empty();
+    }
+    return removed;
+}
+
+bool Matrix::removeDeadRows(ColumnHeader* column_header, std::vector<char>& is_candidate,
+                            PreprocessStatistics& statistics)
+{
+    if(column_header->columnCount == 0) { return false; }
+    // a row that removes all rows of this column conflicts in particular with the first one
+    auto const first = static_cast<MatrixElement*>(column_header->nextInColumn);
+    std::vector<MatrixElement*> candidates;
+    for(auto e = first->nextInRow; e != first; e = e->nextInRow)
+    {
+        if(e->columnHeader->multiplicity != 1) { continue; }
+        for(auto it = e->nextInColumn; it != e; it = it->nextInColumn)
+        {
+            if(it == e->columnHeader) { continue; }
+            auto const element = static_cast<MatrixElement*>(it);
+            if(is_candidate[element->rowIndex]) { continue; }
+            is_candidate[element->rowIndex] = 1;
+            candidates.push_back(element);
+        }
+    }
+
+    std::vector<MatrixElement*> dead;
+    for(auto candidate : candidates)
+    {
+        is_candidate[candidate->rowIndex] = 0;
+        if(rowContainsColumn(candidate, column_header)) { continue; }
+        bool kills_column = true;
+        auto row_it = first->nextInColumn;
+        for(int i=1; i<column_header->columnCount && kills_column; ++i, row_it = row_it->nextInColumn)
+        {
+            kills_column = rowsConflict(candidate, static_cast<MatrixElement*>(row_it));
+        }
+        if(kills_column) { dead.push_back(candidate); }
+    }
+    for(auto element : dead) { removeRow(element); }
+    statistics.removedRows += static_cast<int>(dead.size());
+    return !dead.empty();
+}
+
 Matrix::Solution Matrix::solve()
 {
-    PartialSolution partial_solution;
-    std::vector<Solution> solutions;
-    search(0, partial_solution, solutions, true);
-    return (solutions.empty()) ? Solution() : solutions.back();
+    Solution ret;
+    solveAll([&ret](Solution const& solution) { ret = solution; return false; });
+    return ret;
 }
 
 std::vector<Matrix::Solution> Matrix::solveAll()
 {
-    PartialSolution partial_solution;
     std::vector<Solution> solutions;
-    search(0, partial_solution, solutions, false);
+    solveAll([&solutions](Solution const& solution) { solutions.push_back(solution); return true; });
     return solutions;
 }
 
-Matrix::Solution Matrix::convertPartialSolutionToSolution(PartialSolution const& partial_solution) const
+std::vector<Matrix::Solution> Matrix::solveUpTo(std::size_t n)
+{
+    std::vector<Solution> solutions;
+    if(n == 0) { return solutions; }
+    solveAll([&solutions, n](Solution const& solution) { solutions.push_back(solution); return solutions.size() < n; });
+    return solutions;
+}
+
+void Matrix::solveAll(SolutionCallback const& callback)
+{
+    // every level of the search covers a primary column
+    std::size_t n_primary = 0;
+    for(auto it = m_matrixHeader->nextInHeaderList; it != m_matrixHeader; it = it->nextInHeaderList) { ++n_primary; }
+    m_statistics.reserveDepths(n_primary);
+    PartialSolution partial_solution;
+    search(0, partial_solution, callback);
+    m_statistics.trimDepths();
+}
+
+void Matrix::convertPartialSolutionToSolution(PartialSolution const& partial_solution, Solution& solution) const
 {
-    Solution ret(partial_solution.size());
-    std::transform(begin(partial_solution), end(partial_solution), begin(ret),
+    solution.resize(m_selectedRows.size() + partial_solution.size());
+    auto it = std::copy(begin(m_selectedRows), end(m_selectedRows), begin(solution));
+    std::transform(begin(partial_solution), end(partial_solution), it,
                    [](MatrixElement const* el) { return el->rowIndex; });
-    return ret;
 }
 
-bool Matrix::search(int k, PartialSolution& partial_solution, std::vector<Solution>& solutions,
-                    bool stopAfterFirstSolutionFound)
+// returns true if the callback requested the search to stop
+bool Matrix::search(int k, PartialSolution& partial_solution, SolutionCallback const& callback)
 {
+    ++m_statistics.nodes;
+    ++m_statistics.nodesPerDepth[k];
     if(m_matrixHeader->nextInHeaderList == m_matrixHeader)
     {
         // no more columns, we have a solution
-        solutions.push_back(convertPartialSolutionToSolution(partial_solution));
-        return true;
+        ++m_statistics.solutions;
+        convertPartialSolutionToSolution(partial_solution, m_solutionBuffer);
+        return !callback(m_solutionBuffer);
     }
 
+    if(m_pruningHook && !m_pruningHook(SearchState(*this, k))) { return false; }
+
     // chose an initial column -
     //  this corresponds to chosing a piece to place or a cell to fill
-    ColumnHeader* c = getHeaderWithFewestOccupants();
+    ColumnHeader* c = getBranchingColumn(k);
     coverColumn(c);
+    // each of the rows tried below occupies the column
+    setOccupied(c);
 
     // iterate all rows for the chosen column -
     //  that is, iterate over all possibilities to place the piece / fill the cell
-    bool found_solution = false;
+    bool stop = false;
     auto row_it = c->nextInColumn;
     while(row_it != c) {
         auto selected_element = static_cast<MatrixElement*>(row_it);
@@ -231,31 +1004,123 @@ bool Matrix::search(int k, PartialSolution& partial_solution, std::vector<Soluti
         auto column_it = selected_element->nextInRow;
         while(column_it != selected_element)
         {
-            coverColumn(column_it->columnHeader);
+            selectColumn(column_it->columnHeader);
             column_it = column_it->nextInRow;
         }
 
-        found_solution = search(k+1, partial_solution, solutions, stopAfterFirstSolutionFound);
+        stop = search(k+1, partial_solution, callback);
         partial_solution.pop_back();
 
         // undo the covering done above so we are ready to select a new element in the next iteration
         column_it = selected_element->previousInRow;
         while(column_it != row_it)
         {
-            uncoverColumn(column_it->columnHeader);
+            deselectColumn(column_it->columnHeader);
             column_it = column_it->previousInRow;
         }
         row_it = row_it->nextInColumn;
-        if (stopAfterFirstSolutionFound && found_solution) { break; }
+        if (stop) { break; }
     }
-    // if we end up here without a found_solution, that means we exhausted the current sub-search tree
+    // if we end up here without being stopped, that means we exhausted the current sub-search tree
+    clearOccupied(c);
     uncoverColumn(c);
 
-    return found_solution;
+    return stop;
+}
+
+ColumnHeader* Matrix::getBranchingColumn(int k)
+{
+    if(m_branchingHook) {
+        int const column = m_branchingHook(SearchState(*this, k));
+        if(column != -1) {
+            if(column < 0 || column >= m_nColumns) { PROTOCOL_VIOLATION("Invalid column index"); }
+            auto const column_header = m_columnHeaders[column];
+            // primary columns are linked into the header list exactly while they are uncovered
+            if(column_header->nextInHeaderList == column_header ||
+               column_header->previousInHeaderList->nextInHeaderList != column_header)
+            {
+                PROTOCOL_VIOLATION("Branching column must be an uncovered primary column");
+            }
+            return column_header;
+        }
+    }
+    return getHeaderWithFewestOccupants();
 }
 
-RowHeader const& Matrix::getRowHeader(int rowIndex)
+RowHeader const& Matrix::getRowHeader(int rowIndex) const
 {
     return m_rowHeaders.at(rowIndex);
 }
+
+void Matrix::getRowColumns(int rowIndex, std::vector<int>& columns) const
+{
+    columns.clear();
+    auto const first_in_row = m_rowElements.at(rowIndex);
+    for(auto it = first_in_row; it; it = (it->nextInRow == first_in_row) ? nullptr : it->nextInRow)
+    {
+        columns.push_back(it->columnHeader->columnIndex);
+    }
+}
+
+void Matrix::setColumnMultiplicity(int column, int multiplicity)
+{
+    if(column < 0 || column >= m_nColumns) { PROTOCOL_VIOLATION("Invalid column index"); }
+    if(multiplicity < 1) { PROTOCOL_VIOLATION("Invalid column multiplicity"); }
+    auto column_header = m_columnHeaders[column];
+    if(column_header->multiplicity == 0) { PROTOCOL_VIOLATION("Column is covered"); }
+    // unlink from the header list and link to itself, so that covering and uncovering the column
+    //  leaves the header list untouched
+    column_header->nextInHeaderList->previousInHeaderList = column_header->previousInHeaderList;
+    column_header->previousInHeaderList->nextInHeaderList = column_header->nextInHeaderList;
+    column_header->nextInHeaderList = column_header->previousInHeaderList = column_header;
+    column_header->multiplicity = multiplicity;
+}
+
+void Matrix::setSecondaryColumn(int column)
+{
+    setColumnMultiplicity(column, 1);
+}
+
+void Matrix::deactivateColumn(int column)
+{
+    if(column < 0 || column >= m_nColumns) { PROTOCOL_VIOLATION("Invalid column index"); }
+    auto column_header = m_columnHeaders[column];
+    if(std::find(begin(m_deactivatedColumns), end(m_deactivatedColumns), column_header) != end(m_deactivatedColumns))
+    {
+        PROTOCOL_VIOLATION("Column already deactivated");
+    }
+    coverColumn(column_header);
+    setOccupied(column_header);
+    m_deactivatedColumns.push_back(column_header);
+}
+
+void Matrix::reactivateColumns()
+{
+    for(auto it = m_deactivatedColumns.rbegin(); it != m_deactivatedColumns.rend(); ++it)
+    {
+        clearOccupied(*it);
+        uncoverColumn(*it);
+    }
+    m_deactivatedColumns.clear();
+}
+
+void Matrix::setPruningHook(PruningHook hook)
+{
+    m_pruningHook = std::move(hook);
+}
+
+void Matrix::setBranchingHook(BranchingHook hook)
+{
+    m_branchingHook = std::move(hook);
+}
+
+SearchStatistics const& Matrix::getStatistics() const
+{
+    return m_statistics;
+}
+
+void Matrix::resetStatistics()
+{
+    m_statistics = SearchStatistics();
+}
 }
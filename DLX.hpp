@@ -1,10 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iosfwd>
 #include <memory>
 #include <new>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace DLX
@@ -33,9 +38,10 @@ namespace DLX
     {
         int columnCount;
         int columnIndex;
+        int multiplicity;       ///< number of rows that may still be selected for this column
 
         ColumnHeader()
-            :columnCount(0), columnIndex(-1)
+            :columnCount(0), columnIndex(-1), multiplicity(1)
         {}
     };
 
@@ -75,6 +81,57 @@ namespace DLX
 
     typedef std::function<void(std::ostream&, void const*)> RowHeaderUserDataPrinter;
 
+    /*! Deterministic work counters collected during the search.
+     * Unlike wall-clock timings these do not depend on the machine the search runs on,
+     * which makes them suitable for detecting algorithmic regressions.
+     */
+    struct SearchStatistics
+    {
+        std::uint64_t nodes;            ///< number of invocations of the recursive search
+        std::uint64_t linkUpdates;      ///< number of nodes unlinked or relinked by cover/uncover
+        std::uint64_t solutions;        ///< number of solutions found
+        std::vector<std::uint64_t> nodesPerDepth;   ///< nodes by depth of the search tree
+
+        SearchStatistics()
+            :nodes(0), linkUpdates(0), solutions(0)
+        {}
+
+        /*! Make room for the nodes down to max_depth before a search, so that the search can count nodes
+         * per depth without checking the size at every node.
+         */
+        void reserveDepths(std::size_t max_depth)
+        {
+            if(nodesPerDepth.size() <= max_depth) { nodesPerDepth.resize(max_depth + 1); }
+        }
+
+        /*! Drop the depths reserved by reserveDepths() that the search never reached.
+         */
+        void trimDepths()
+        {
+            while(!nodesPerDepth.empty() && nodesPerDepth.back() == 0) { nodesPerDepth.pop_back(); }
+        }
+    };
+
+    /*! Summary of the reductions applied by Matrix::preprocess().
+     */
+    struct PreprocessStatistics
+    {
+        int removedRows;        ///< rows that cannot be part of any solution
+        int forcedRows;         ///< rows that are part of every solution, now selected
+        int removedColumns;     ///< primary columns covered by the forced rows
+        int passes;             ///< number of rounds until no reduction applied any more
+        bool infeasible;        ///< a primary column has no rows left, so there is no solution
+
+        PreprocessStatistics()
+            :removedRows(0), forcedRows(0), removedColumns(0), passes(0), infeasible(false)
+        {}
+    };
+
+    /*! Arena allocator for the nodes of a Matrix.
+     * Memory is handed out from a list of blocks and only released when the Storage is destroyed.
+     * A Storage can be presized so that a whole matrix lives in a single contiguous block, and reset()
+     * allows reusing all blocks for the next matrix without going back to the system allocator.
+     */
     class Storage
     {
         Storage(Storage const&)=delete;
@@ -82,81 +139,375 @@ namespace DLX
     private:
         struct Block
         {
-            Block(std::size_t block_size) : memory(new char[block_size]) {}
-            Block(Block&& rhs) : memory(std::move(rhs.memory)) {}
-            ~Block() {}
-            std::unique_ptr<char[]> memory;
+            Block(std::size_t block_size, bool use_huge_pages);
+            Block(Block&& rhs);
+            ~Block();
+            Block(Block const&)=delete;
+            Block& operator=(Block const&)=delete;
+
+            char* memory;
+            std::size_t size;
+            std::size_t used;       ///< bytes in use, only valid for blocks before the current one
+            bool isMapped;
         };
     public:
+        /*! Maps the addresses of objects in one Storage to the addresses of their copies in another.
+         */
+        class Relocation
+        {
+        public:
+            template<typename T>
+            T* operator()(T const* p) const
+            {
+                if(!p) { return nullptr; }
+                auto const address = reinterpret_cast<char const*>(p);
+                auto it = m_ranges.begin();
+                if(m_ranges.size() > 1) {
+                    it = std::upper_bound(m_ranges.begin(), m_ranges.end(), address,
+                                          [](char const* a, Range const& r) { return a < r.oldBegin; }) - 1;
+                }
+                return reinterpret_cast<T*>(it->newBegin + (address - it->oldBegin));
+            }
+
+        private:
+            friend class Storage;
+            struct Range
+            {
+                char const* oldBegin;
+                char* newBegin;
+            };
+            std::vector<Range> m_ranges;    ///< sorted by oldBegin
+        };
+
+        /*! Alignment of the start of each block, chosen as a cache line so that nodes do not straddle lines
+         * more than necessary.
+         */
+        static constexpr std::size_t BlockAlignment = 64;
+
         Storage()
-            :m_blockSize(1024*1024), m_offset(0), m_bytesWasted(0)
+            :m_blockSize(1024*1024), m_useHugePages(false), m_currentBlock(0), m_offset(0), m_bytesWasted(0)
         {
-            m_storage.push_back(Block(m_blockSize));
+            m_storage.push_back(Block(m_blockSize, m_useHugePages));
+        }
+
+        /*! Construct a Storage whose first block holds at least capacity bytes.
+         * If use_huge_pages is set, blocks are backed by transparent huge pages where the platform supports it,
+         * to reduce TLB misses when traversing large matrices.
+         */
+        explicit Storage(std::size_t capacity, bool use_huge_pages = false)
+            :m_blockSize(1024*1024), m_useHugePages(use_huge_pages), m_currentBlock(0), m_offset(0), m_bytesWasted(0)
+        {
+            m_storage.push_back(Block(std::max(capacity, m_blockSize), m_useHugePages));
         }
 
         Storage(Storage&& rhs) : m_storage(std::move(rhs.m_storage)), m_blockSize(rhs.m_blockSize),
+                                 m_useHugePages(rhs.m_useHugePages), m_currentBlock(rhs.m_currentBlock),
                                  m_offset(rhs.m_offset), m_bytesWasted(rhs.m_bytesWasted)
         {}
 
+        Storage& operator=(Storage&& rhs) = default;
+
         template<typename T>
         T* allocate()
         {
-            if(m_blockSize - m_offset < sizeof(T))
+            static_assert(alignof(T) <= BlockAlignment, "Type is over-aligned for Storage");
+            static_assert(std::is_trivially_destructible_v<T>, "Storage never destroys its objects");
+            std::size_t aligned_offset = (m_offset + alignof(T) - 1) & ~(alignof(T) - 1);
+            if(m_storage[m_currentBlock].size < aligned_offset + sizeof(T))
             {
-                m_storage.push_back(Block(m_blockSize));
-                m_bytesWasted += m_blockSize - m_offset;
-                m_offset = 0;
+                nextBlock(sizeof(T));
+                aligned_offset = 0;
             }
-            auto mem = m_storage.back().memory.get() + m_offset;
+            m_bytesWasted += aligned_offset - m_offset;
+            auto mem = m_storage[m_currentBlock].memory + aligned_offset;
             T* ret = new(mem) T();
-            m_offset += sizeof(T);
+            m_offset = aligned_offset + sizeof(T);
             return ret;
         }
 
+        /*! Number of bytes needed to allocate count objects of type T in one piece.
+         */
+        template<typename T>
+        static constexpr std::size_t requiredBytes(std::size_t count)
+        {
+            return count * sizeof(T) + alignof(T);
+        }
+
+        /*! Make sure that the next bytes bytes can be allocated from a single block.
+         */
+        void reserve(std::size_t bytes);
+
+        /*! Release all objects at once while keeping the blocks for reuse.
+         * The objects are not destroyed, so only trivially destructible types may be allocated.
+         */
+        void reset();
+
+        std::size_t getBytesWasted() const
+        {
+            return m_bytesWasted;
+        }
+
+        bool usesHugePages() const
+        {
+            return m_useHugePages;
+        }
+
+        /*! Number of bytes that copyFrom() needs to hold a copy of all objects of this Storage in one block.
+         */
+        std::size_t getCopySize() const;
+
+        /*! Replace the contents of this Storage by a bitwise copy of all objects in source.
+         * All objects end up in a single block. Pointers between the copied objects still point into source
+         * and have to be adjusted with the returned Relocation.
+         */
+        Relocation copyFrom(Storage const& source);
+
+    private:
+        void nextBlock(std::size_t min_size);
+
     private:
         std::vector<Block> m_storage;
-        std::size_t const m_blockSize;
+        std::size_t m_blockSize;
+        bool m_useHugePages;
+        std::size_t m_currentBlock;
         std::size_t m_offset;
         std::size_t m_bytesWasted;
     };
 
+    class Matrix;
+
+    /*! Read-only view of the state of a search, handed to the hooks of a Matrix.
+     * The occupancy of the columns is maintained incrementally on the same events that cover and uncover
+     * them, so all queries take constant time. For polyomino problems, the occupancy of the cell columns
+     * is the occupancy of the board and the remaining count of the piece or shape columns is the number
+     * of pieces still to be placed.
+     * A view is only valid for the duration of the hook call it is passed to.
+     */
+    class SearchState
+    {
+    public:
+        SearchState(Matrix const& matrix, int depth)
+            :m_matrix(&matrix), m_depth(depth)
+        {}
+
+        /*! Number of rows chosen by the search so far, not counting rows selected before the search.
+         */
+        int getDepth() const
+        {
+            return m_depth;
+        }
+
+        int getColumnCount() const;
+
+        /*! Whether a column is occupied by a selected row or a row chosen by the search.
+         * A secondary column counts as occupied once its multiplicity is used up, a deactivated column
+         * is always occupied.
+         */
+        bool isOccupied(int column) const;
+
+        /*! Number of further rows through a column that a solution may still contain: 0 for occupied columns,
+         * otherwise 1 for primary columns and the remaining multiplicity for secondary columns.
+         */
+        int getRemaining(int column) const;
+
+        /*! The occupancy as a bitboard, bit (i % 64) of word (i / 64) being set if column i is occupied.
+         * Bits beyond the last column are zero.
+         */
+        std::span<std::uint64_t const> getOccupancy() const;
+
+    private:
+        Matrix const* m_matrix;
+        int m_depth;
+    };
+
     class Matrix
     {
     public:
         // the solution is given as a list of row indices
         typedef std::vector<int> Solution;
+        /*! Receives each solution as it is found. Returning false stops the search.
+         * The solution is only valid for the duration of the call.
+         */
+        typedef std::function<bool(Solution const&)> SolutionCallback;
+        /*! Called at every node of the search before branching. Returning false abandons the node.
+         */
+        typedef std::function<bool(SearchState const&)> PruningHook;
+        /*! Called at every node of the search to choose the column to branch on.
+         * Returns the index of an uncovered primary column, or -1 to fall back to the column with the fewest rows.
+         */
+        typedef std::function<int(SearchState const&)> BranchingHook;
     public:
         Matrix(int nColumns);
 
-        Matrix(Matrix&& rhs) : m_nColumns(rhs.m_nColumns), m_nRows(rhs.m_nRows), m_storage(std::move(rhs.m_storage)),
-                               m_matrixHeader(rhs.m_matrixHeader), m_rowHeaders(std::move(rhs.m_rowHeaders))
-        {}
+        /*! Construct a matrix whose nodes fit into a single contiguous allocation.
+         * nRows and nNonZeros are the number of rows and of occupied fields that will be added.
+         */
+        Matrix(int nColumns, int nRows, std::size_t nNonZeros, bool use_huge_pages = false);
+
+        Matrix(Matrix&& rhs) = default;
+
+        /*! Reserve space for the row headers of nRows rows.
+         * Calling this with the exact number of rows before adding them avoids reallocations during construction.
+         */
+        void reserveRows(int nRows);
+
+        /*! Remove all rows and columns and start over with an empty matrix of nColumns columns.
+         * The memory of the previous matrix is reused.
+         */
+        void reset(int nColumns, int nRows = 0, std::size_t nNonZeros = 0);
 
         void addRow(RowHeader const& row_header, std::vector<int> const& occupied_fields);
 
+        /*! Add a row given as an array of column indices.
+         * Nodes are linked by direct lookup of their column header, so the cost is proportional to the
+         * number of occupied fields rather than to the number of columns. Column indices are expected
+         * to be sorted in ascending order; unsorted input is sorted on a local copy.
+         */
+        void addRow(RowHeader const& row_header, int const* occupied_fields, int n_occupied);
+
         void printMatrix(std::ostream& os, int pieceCount, int field_width,
                          RowHeaderUserDataPrinter const& pretty_printer, bool compact) const;
 
         void printRow(int rowIndex, std::ostream& os, int pieceCount, int field_width,
                       RowHeaderUserDataPrinter const& pretty_printer, bool compact) const;
 
+        /*! Copy the matrix including its current state.
+         * The nodes are copied in bulk and their links relocated in a single pass, so the cost is linear in
+         * the number of nodes. Covered columns, deactivated columns and selected rows are preserved.
+         */
         Matrix clone() const;
 
+        /*! Rearrange the nodes in memory so that nodes visited together during the search are close together.
+         * Rows are laid out grouped by the lowest column they occupy among the columns starting at firstKeyColumn,
+         * so that the nodes of a column lie in a narrow band of memory. For polyomino problems, passing the index
+         * of the first cell column groups rows by the first board cell they cover.
+         * Only the memory layout changes: row indices, the order of all lists and the current state are preserved,
+         * so the search visits the same nodes in the same order and reports the same solutions.
+         * Must not be called during a search.
+         */
+        void optimizeLayout(int firstKeyColumn = 0);
+
+        /*! Write the complete state of the matrix to a stream.
+         * This includes partially covered states, so a matrix with selected rows can be shipped to a
+         * worker and searched there. Row header user data is not written.
+         */
+        void serialize(std::ostream& os) const;
+
+        /*! Read a matrix written by serialize(), which must make up the rest of the stream.
+         * row_headers supplies the user data for the rows; if empty, rows get default row headers.
+         * Throws std::runtime_error if the stream does not contain a valid matrix.
+         */
+        static Matrix deserialize(std::istream& is, std::vector<RowHeader> const& row_headers = std::vector<RowHeader>());
+
+        /*! Fix a row as part of all solutions, by covering its columns as the search would when choosing it.
+         * The row must not conflict with previously selected rows, and none of its columns may be covered,
+         * deactivated or used up to its multiplicity. Selected rows are reported at the front of every solution.
+         */
+        void selectRow(int rowIndex);
+
+        /*! Undo the most recent selectRow().
+         */
+        void unselectRow();
+
+        std::vector<int> const& getSelectedRows() const
+        {
+            return m_selectedRows;
+        }
+
         bool isOccupied(int row, int col) const;
 
+        /*! Simplify the matrix by iterated local reductions, until none of them applies any more:
+         *  - a primary column with a single row forces that row, which is selected as by selectRow();
+         *  - if the rows of a primary column are a subset of the rows of another column, the remaining rows
+         *    of the other column are removed;
+         *  - a row whose selection would leave a primary column without rows is removed. For polyomino
+         *    problems these are the placements that seal off a pocket that no remaining piece fits into.
+         * The reduced matrix has the same solutions as the original one.
+         * The reductions are permanent: rows selected so far must not be unselected afterwards.
+         * Must not be called during a search.
+         */
+        PreprocessStatistics preprocess();
+
         Solution solve();
 
         std::vector<Solution> solveAll();
 
-        RowHeader const& getRowHeader(int rowIndex);
+        /*! Collect at most n solutions, stopping the search as soon as the n-th one is found.
+         * solveUpTo(2) tells whether a problem has a unique solution without enumerating all of them.
+         */
+        std::vector<Solution> solveUpTo(std::size_t n);
+
+        /*! Enumerate solutions without collecting them, handing each one to callback as soon as it is found.
+         */
+        void solveAll(SolutionCallback const& callback);
+
+        int getRowCount() const
+        {
+            return m_nRows;
+        }
+
+        RowHeader const& getRowHeader(int rowIndex) const;
+
+        /*! Get the indices of the columns occupied by a row, in ascending order.
+         * The cost is proportional to the number of occupied fields in the row.
+         */
+        void getRowColumns(int rowIndex, std::vector<int>& columns) const;
+
+        /*! Turn a column into a secondary column that may be covered by up to multiplicity rows of a solution.
+         * Secondary columns are never chosen for branching. Each selected row through the column counts down
+         * its multiplicity; once it reaches zero, all remaining rows through the column are removed.
+         * Must not be called during a search.
+         */
+        void setColumnMultiplicity(int column, int multiplicity);
+
+        /*! Turn a column into a secondary column that is covered at most once instead of exactly once.
+         */
+        void setSecondaryColumn(int column);
+
+        /*! Remove all rows through a column from the matrix, together with the column itself.
+         * Deactivated columns are restored in reverse order by reactivateColumns(), which allows a single
+         * matrix to be reused for sub-problems that only use a subset of its rows.
+         */
+        void deactivateColumn(int column);
+
+        /*! Undo all deactivateColumn() calls since the last call to this function.
+         */
+        void reactivateColumns();
+
+        /*! Install a hook that may cut off branches of the search, or remove it by passing an empty function.
+         * A hook that abandons nodes with solutions below them changes the solutions that are found.
+         */
+        void setPruningHook(PruningHook hook);
+
+        /*! Install a hook that chooses the column to branch on, or remove it by passing an empty function.
+         */
+        void setBranchingHook(BranchingHook hook);
+
+        /*! State of the matrix outside of a search, with no rows chosen by the search.
+         */
+        SearchState getSearchState() const
+        {
+            return SearchState(*this, 0);
+        }
+
+        SearchStatistics const& getStatistics() const;
+
+        void resetStatistics();
 
     private:
         typedef std::vector<MatrixElement const*> PartialSolution;
 
-        Solution convertPartialSolutionToSolution(PartialSolution const& partial_solution) const;
+        struct Uninitialized {};
+
+        Matrix(Uninitialized, int nColumns, std::size_t capacity, bool use_huge_pages);
+
+        static std::size_t requiredBytes(int nColumns, std::size_t nNonZeros);
 
-        bool search(int k, PartialSolution& partial_solution, std::vector<Solution>& solutions,
-                    bool stopAfterFirstSolutionFound);
+        void initializeHeaders();
+
+        void convertPartialSolutionToSolution(PartialSolution const& partial_solution, Solution& solution) const;
+
+        bool search(int k, PartialSolution& partial_solution, SolutionCallback const& callback);
 
         ColumnHeader* getHeaderWithFewestOccupants();
 
@@ -164,11 +515,65 @@ namespace DLX
 
         void uncoverColumn(ColumnHeader* column_header);
 
+        void selectColumn(ColumnHeader* column_header);
+
+        void deselectColumn(ColumnHeader* column_header);
+
+        void setOccupied(ColumnHeader const* column_header)
+        {
+            m_occupiedColumns[column_header->columnIndex / 64] |= std::uint64_t(1) << (column_header->columnIndex % 64);
+        }
+
+        void clearOccupied(ColumnHeader const* column_header)
+        {
+            m_occupiedColumns[column_header->columnIndex / 64] &= ~(std::uint64_t(1) << (column_header->columnIndex % 64));
+        }
+
+        ColumnHeader* getBranchingColumn(int k);
+
+        void removeRow(MatrixElement* element);
+
+        bool removeDominatedRows(ColumnHeader* column_header, PreprocessStatistics& statistics);
+
+        bool removeDeadRows(ColumnHeader* column_header, std::vector<char>& is_candidate,
+                            PreprocessStatistics& statistics);
+
     private:
         int m_nColumns;
         int m_nRows;
         Storage m_storage;
         Header* m_matrixHeader;
+        std::vector<ColumnHeader*> m_columnHeaders;
         std::vector<RowHeader> m_rowHeaders;
+        std::vector<MatrixElement*> m_rowElements;      ///< first element of each row
+        std::vector<ColumnHeader*> m_deactivatedColumns;
+        std::vector<int> m_selectedRows;
+        SearchStatistics m_statistics;
+        Solution m_solutionBuffer;
+        std::vector<std::uint64_t> m_occupiedColumns;  ///< bitboard of occupied columns, see SearchState
+        PruningHook m_pruningHook;
+        BranchingHook m_branchingHook;
+
+        friend class SearchState;
     };
+
+    inline int SearchState::getColumnCount() const
+    {
+        return m_matrix->m_nColumns;
+    }
+
+    inline bool SearchState::isOccupied(int column) const
+    {
+        return (m_matrix->m_occupiedColumns[column / 64] >> (column % 64)) & 1;
+    }
+
+    inline int SearchState::getRemaining(int column) const
+    {
+        return isOccupied(column) ? 0 : m_matrix->m_columnHeaders[column]->multiplicity;
+    }
+
+    inline std::span<std::uint64_t const> SearchState::getOccupancy() const
+    {
+        return std::span<std::uint64_t const>(m_matrix->m_occupiedColumns);
+    }
 }
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <polyomino.hpp>
+#include <problem_instance.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! A placement on a field of at most 64 cells, with the cells covered as bits in row-major order.
+ */
+struct BitboardCandidate
+{
+    std::uint64_t mask;
+    std::uint8_t shape;
+    std::uint8_t rotation;
+    std::uint8_t x;
+    std::uint8_t y;
+};
+
+/*! Solver for the rectangular fields of one size, specialized at compile time through Field_T.
+ * Field_T is emitted by solver_generator and provides:
+ *  - static constexpr int Width, Height;
+ *  - static constexpr BitboardCandidate Candidates[]: all placements on the field, grouped by their first cell
+ *    in row-major order;
+ *  - static constexpr int CandidateBegin[Width * Height + 1]: index of the first candidate of each cell group.
+ * The search always fills the first empty cell, so it only ever looks at the candidates of that cell, and a
+ * placement fits if its mask does not intersect the occupied cells.
+ *
+ * Identical pieces are interchangeable, so each tiling is reported once, as with MasterMatrix.
+ */
+template<typename Shape_T, typename Field_T>
+class BitboardSolver
+{
+    BitboardSolver(BitboardSolver const&)=delete;
+    BitboardSolver& operator=(BitboardSolver const&)=delete;
+public:
+    typedef std::vector<FixedPlacement<Shape_T>> Solution;
+    typedef std::function<bool(Solution const&)> SolutionCallback;
+
+    static constexpr int ShapeCount = static_cast<int>(Shape_T::END);
+    static constexpr int CellCount = Field_T::Width * Field_T::Height;
+    static_assert(CellCount <= 64, "Field does not fit into a bitboard");
+
+public:
+    explicit BitboardSolver(std::vector<Shape_T> const& pieces)
+        :m_remainingPieces{}
+    {
+        for(auto const& s : pieces) { ++m_remainingPieces[static_cast<int>(s)]; }
+        m_partialSolution.reserve(pieces.size());
+    }
+
+    void solveAll(SolutionCallback const& callback)
+    {
+        // the bits beyond the field are occupied from the start, so a full board is all ones
+        // every level of the search places one piece
+        m_statistics.reserveDepths(std::accumulate(begin(m_remainingPieces), end(m_remainingPieces), 0));
+        search(~FieldMask, callback);
+        m_statistics.trimDepths();
+    }
+
+    DLX::SearchStatistics const& getStatistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    static constexpr std::uint64_t FieldMask = (CellCount == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << CellCount) - 1;
+
+    // returns true if the callback requested the search to stop
+    bool search(std::uint64_t occupied, SolutionCallback const& callback)
+    {
+        auto const depth = m_partialSolution.size();
+        ++m_statistics.nodes;
+        ++m_statistics.nodesPerDepth[depth];
+        if(occupied == ~std::uint64_t(0))
+        {
+            ++m_statistics.solutions;
+            return !callback(m_partialSolution);
+        }
+
+        int const cell = std::countr_zero(~occupied);
+        for(int i = Field_T::CandidateBegin[cell]; i < Field_T::CandidateBegin[cell + 1]; ++i)
+        {
+            auto const& candidate = Field_T::Candidates[i];
+            if((candidate.mask & occupied) || m_remainingPieces[candidate.shape] == 0) { continue; }
+            --m_remainingPieces[candidate.shape];
+            m_partialSolution.push_back(FixedPlacement<Shape_T>{ static_cast<Shape_T>(candidate.shape), candidate.rotation,
+                                                                 candidate.x, candidate.y });
+            bool const stop = search(occupied | candidate.mask, callback);
+            m_partialSolution.pop_back();
+            ++m_remainingPieces[candidate.shape];
+            if(stop) { return true; }
+        }
+        return false;
+    }
+
+private:
+    std::array<int, ShapeCount> m_remainingPieces;
+    Solution m_partialSolution;
+    DLX::SearchStatistics m_statistics;
+};
+
+}
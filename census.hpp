@@ -0,0 +1,129 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <exceptions.hpp>
+#include <master_matrix.hpp>
+#include <polyomino.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! Number of tilings of a rectangular field for every piece multiset, found in a single search.
+ * Instead of solving one problem per multiset, the search runs on the master matrix with every shape
+ * available any number of times, and each tiling is tallied under the multiset of shapes it uses.
+ * As with MasterMatrix, identical pieces are interchangeable, so each tiling is counted once.
+ * Multisets without any tiling do not appear in the table.
+ *
+ * Every tiling covers the first cell of the field with exactly one placement, so the search is split
+ * into one independent sub-search per placement on that cell, which are distributed over the threads.
+ */
+template<typename Shape_T>
+class Census
+{
+public:
+    static constexpr int ShapeCount = MasterMatrix<Shape_T>::ShapeCount;
+
+    /*! Number of pieces of each shape, indexed by shape.
+     */
+    typedef std::array<int, ShapeCount> ShapeCounts;
+
+    typedef std::map<ShapeCounts, std::uint64_t> Table;
+
+public:
+    explicit Census(FieldSize const& field_size)
+        :m_master(field_size), m_tilingCount(0)
+    {}
+
+    /*! Run the census on n_threads threads. Previous results are discarded.
+     */
+    void run(int n_threads = 1)
+    {
+        if(n_threads < 1) { PROTOCOL_VIOLATION("Census needs at least one thread"); }
+        m_table.clear();
+        m_tilingCount = 0;
+        m_statistics = DLX::SearchStatistics();
+
+        auto const field_size = m_master.getFieldSize();
+        auto const& master_matrix = m_master.getMatrix();
+        std::vector<int> first_cell_rows;
+        std::vector<int> columns;
+        for(int i=0; i<master_matrix.getRowCount(); ++i)
+        {
+            master_matrix.getRowColumns(i, columns);
+            if(std::find(begin(columns), end(columns), ShapeCount) != end(columns)) { first_cell_rows.push_back(i); }
+        }
+
+        std::atomic<std::size_t> next_row(0);
+        std::vector<Table> tables(n_threads);
+        std::vector<DLX::SearchStatistics> statistics(n_threads);
+        auto const worker = [&, this](int thread_index) {
+            auto m = master_matrix.clone();
+            int const max_pieces = field_size.x * field_size.y / Degree<Shape_T>::value;
+            for(int i=0; i<ShapeCount; ++i) { m.setColumnMultiplicity(i, std::max(max_pieces, 1)); }
+            auto& table = tables[thread_index];
+            for(std::size_t r = next_row++; r < first_cell_rows.size(); r = next_row++)
+            {
+                m.selectRow(first_cell_rows[r]);
+                m.solveAll([this, &table](DLX::Matrix::Solution const& solution) {
+                    ShapeCounts counts{};
+                    for(auto const row : solution) { ++counts[static_cast<int>(m_master.getPlacementRecord(row).shape)]; }
+                    ++table[counts];
+                    return true;
+                });
+                m.unselectRow();
+            }
+            statistics[thread_index] = m.getStatistics();
+        };
+        std::vector<std::thread> threads;
+        for(int i=1; i<n_threads; ++i) { threads.emplace_back(worker, i); }
+        worker(0);
+        for(auto& t : threads) { t.join(); }
+
+        for(int i=0; i<n_threads; ++i)
+        {
+            for(auto const& [counts, n] : tables[i])
+            {
+                m_table[counts] += n;
+                m_tilingCount += n;
+            }
+            m_statistics.nodes += statistics[i].nodes;
+            m_statistics.linkUpdates += statistics[i].linkUpdates;
+            m_statistics.solutions += statistics[i].solutions;
+        }
+    }
+
+    Table const& getTable() const
+    {
+        return m_table;
+    }
+
+    /*! Total number of tilings over all multisets.
+     */
+    std::uint64_t getTilingCount() const
+    {
+        return m_tilingCount;
+    }
+
+    /*! Work counters of the search, summed over all threads.
+     */
+    DLX::SearchStatistics const& getStatistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    MasterMatrix<Shape_T> m_master;     ///< only read during a run, the threads search on copies
+    Table m_table;
+    std::uint64_t m_tilingCount;
+    DLX::SearchStatistics m_statistics;
+};
+
+}
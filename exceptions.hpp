@@ -1,3 +1,5 @@
+#pragma once
+
 #include <stdexcept>
 
 #define PROTOCOL_VIOLATION(msg) throw std::logic_error(msg)
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <polyomino.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace Tetromino
+{
+    namespace OneSided
+    {
+        typedef std::function<bool(std::vector<Polyomino::FixedPlacement<Shape>> const&)> GeneratedSolverCallback;
+
+        /*! Enumerate the tilings of a completely open field by exactly the given pieces, reporting each tiling once
+         * as with Polyomino::BitboardSolver. Returning false from the callback stops the search.
+         */
+        typedef DLX::SearchStatistics (*GeneratedSolver)(std::vector<Shape> const& pieces,
+                                                         GeneratedSolverCallback const& callback);
+
+        /*! Solver generated at build time for a field size, or nullptr if there is none.
+         * The field sizes are chosen with the CMake option TETROMINO_GENERATED_FIELD_SIZES.
+         */
+        GeneratedSolver findGeneratedSolver(Polyomino::FieldSize const& field_size);
+    }
+}
@@ -0,0 +1,57 @@
+#include <hexomino.hpp>
+
+#include <ostream>
+
+namespace Hexomino
+{
+namespace Free
+{
+
+std::ostream& operator<<(std::ostream& os, Shape const& s)
+{
+    using Hexomino::Free::Shape;
+    switch(s)
+    {
+        case Shape::H01: return os << "H01";
+        case Shape::H02: return os << "H02";
+        case Shape::H03: return os << "H03";
+        case Shape::H04: return os << "H04";
+        case Shape::H05: return os << "H05";
+        case Shape::H06: return os << "H06";
+        case Shape::H07: return os << "H07";
+        case Shape::H08: return os << "H08";
+        case Shape::H09: return os << "H09";
+        case Shape::H10: return os << "H10";
+        case Shape::H11: return os << "H11";
+        case Shape::H12: return os << "H12";
+        case Shape::H13: return os << "H13";
+        case Shape::H14: return os << "H14";
+        case Shape::H15: return os << "H15";
+        case Shape::H16: return os << "H16";
+        case Shape::H17: return os << "H17";
+        case Shape::H18: return os << "H18";
+        case Shape::H19: return os << "H19";
+        case Shape::H20: return os << "H20";
+        case Shape::H21: return os << "H21";
+        case Shape::H22: return os << "H22";
+        case Shape::H23: return os << "H23";
+        case Shape::H24: return os << "H24";
+        case Shape::H25: return os << "H25";
+        case Shape::H26: return os << "H26";
+        case Shape::H27: return os << "H27";
+        case Shape::H28: return os << "H28";
+        case Shape::H29: return os << "H29";
+        case Shape::H30: return os << "H30";
+        case Shape::H31: return os << "H31";
+        case Shape::H32: return os << "H32";
+        case Shape::H33: return os << "H33";
+        case Shape::H34: return os << "H34";
+        case Shape::H35: return os << "H35";
+        default: return os << "<Invalid Shape>";
+    }
+}
+
+static_assert(Polyomino::countOrientations(placementTable) == 216, "There are 216 fixed hexominoes");
+
+}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <polyomino.hpp>
+
+#include <array>
+#include <iosfwd>
+
+namespace Hexomino
+{
+    namespace Free
+    {
+        enum class Shape
+        {
+            H01 = 0,
+            H02,
+            H03,
+            H04,
+            H05,
+            H06,
+            H07,
+            H08,
+            H09,
+            H10,
+            H11,
+            H12,
+            H13,
+            H14,
+            H15,
+            H16,
+            H17,
+            H18,
+            H19,
+            H20,
+            H21,
+            H22,
+            H23,
+            H24,
+            H25,
+            H26,
+            H27,
+            H28,
+            H29,
+            H30,
+            H31,
+            H32,
+            H33,
+            H34,
+            H35,
+            END
+        };
+
+        std::ostream& operator<<(std::ostream& os, Shape const& s);
+    }
+}
+
+namespace Polyomino
+{
+template<>
+struct Degree<Hexomino::Free::Shape>
+{
+    enum Value_T { value = 6 };
+};
+}
+
+namespace Hexomino
+{
+    namespace Free
+    {
+        using Placement = Polyomino::GenericPlacement<Shape>;
+
+        inline Shape begin()
+        {
+            return Shape::H01;
+        }
+
+        inline Shape end()
+        {
+            return Shape::END;
+        }
+
+        inline Shape inc(Shape s)
+        {
+            return (s == Shape::END) ? Shape::END : static_cast<Shape>(static_cast<int>(s) + 1);
+        }
+
+        inline constexpr std::array<Polyomino::OrientationSet<Shape>, static_cast<int>(Shape::END)> placementTable = {
+            Polyomino::generateOrientations<Shape>("######", Polyomino::Symmetry::Free),          // H01
+            Polyomino::generateOrientations<Shape>("###../..###", Polyomino::Symmetry::Free),     // H02
+            Polyomino::generateOrientations<Shape>("##.../.####", Polyomino::Symmetry::Free),     // H03
+            Polyomino::generateOrientations<Shape>("..#../#####", Polyomino::Symmetry::Free),     // H04
+            Polyomino::generateOrientations<Shape>("...#./#####", Polyomino::Symmetry::Free),     // H05
+            Polyomino::generateOrientations<Shape>("....#/#####", Polyomino::Symmetry::Free),     // H06
+            Polyomino::generateOrientations<Shape>("###./.###", Polyomino::Symmetry::Free),       // H07
+            Polyomino::generateOrientations<Shape>("##.#/.###", Polyomino::Symmetry::Free),       // H08
+            Polyomino::generateOrientations<Shape>("#..#/####", Polyomino::Symmetry::Free),       // H09
+            Polyomino::generateOrientations<Shape>(".##./####", Polyomino::Symmetry::Free),       // H10
+            Polyomino::generateOrientations<Shape>(".#.#/####", Polyomino::Symmetry::Free),       // H11
+            Polyomino::generateOrientations<Shape>("..##/####", Polyomino::Symmetry::Free),       // H12
+            Polyomino::generateOrientations<Shape>("##../.##./..##", Polyomino::Symmetry::Free),  // H13
+            Polyomino::generateOrientations<Shape>("##../.#../.###", Polyomino::Symmetry::Free),  // H14
+            Polyomino::generateOrientations<Shape>("#.../####/...#", Polyomino::Symmetry::Free),  // H15
+            Polyomino::generateOrientations<Shape>("#.../###./..##", Polyomino::Symmetry::Free),  // H16
+            Polyomino::generateOrientations<Shape>("#.../##../.###", Polyomino::Symmetry::Free),  // H17
+            Polyomino::generateOrientations<Shape>(".#../####/..#.", Polyomino::Symmetry::Free),  // H18
+            Polyomino::generateOrientations<Shape>(".#../####/...#", Polyomino::Symmetry::Free),  // H19
+            Polyomino::generateOrientations<Shape>(".#../###./..##", Polyomino::Symmetry::Free),  // H20
+            Polyomino::generateOrientations<Shape>(".#../##../.###", Polyomino::Symmetry::Free),  // H21
+            Polyomino::generateOrientations<Shape>("..#./####/..#.", Polyomino::Symmetry::Free),  // H22
+            Polyomino::generateOrientations<Shape>("..#./####/...#", Polyomino::Symmetry::Free),  // H23
+            Polyomino::generateOrientations<Shape>("..#./###./..##", Polyomino::Symmetry::Free),  // H24
+            Polyomino::generateOrientations<Shape>("..#./..#./####", Polyomino::Symmetry::Free),  // H25
+            Polyomino::generateOrientations<Shape>("...#/####/...#", Polyomino::Symmetry::Free),  // H26
+            Polyomino::generateOrientations<Shape>("...#/...#/####", Polyomino::Symmetry::Free),  // H27
+            Polyomino::generateOrientations<Shape>("###/###", Polyomino::Symmetry::Free),         // H28
+            Polyomino::generateOrientations<Shape>("#../###/.##", Polyomino::Symmetry::Free),     // H29
+            Polyomino::generateOrientations<Shape>(".##/##./.##", Polyomino::Symmetry::Free),     // H30
+            Polyomino::generateOrientations<Shape>(".##/.#./###", Polyomino::Symmetry::Free),     // H31
+            Polyomino::generateOrientations<Shape>(".#./###/.##", Polyomino::Symmetry::Free),     // H32
+            Polyomino::generateOrientations<Shape>(".#./.##/###", Polyomino::Symmetry::Free),     // H33
+            Polyomino::generateOrientations<Shape>("..#/#.#/###", Polyomino::Symmetry::Free),     // H34
+            Polyomino::generateOrientations<Shape>("..#/.##/###", Polyomino::Symmetry::Free)      // H35
+        };
+
+        constexpr int getRotations(Shape const& s)
+        {
+            return placementTable[static_cast<int>(s)].count;
+        }
+
+        constexpr Placement const& getPlacement(Shape s, int rotation)
+        {
+            auto const& orientations = placementTable[static_cast<int>(s)];
+            if(rotation < 0 || rotation >= orientations.count) { PROTOCOL_VIOLATION("Invalid rotation"); }
+            return orientations.orientations[rotation];
+        }
+    }
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <exceptions.hpp>
+#include <polyomino.hpp>
+#include <problem_instance.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! Solver that never builds the problem matrix.
+ * The search works on an implicit exact cover matrix: the columns are the open cells and the remaining pieces,
+ * and the rows of a column are generated from the placement tables only when the search looks at it.
+ * Memory is therefore proportional to the field area plus the search depth instead of the number of placements,
+ * which makes this the better choice for finding a first solution on large boards.
+ *
+ * Identical pieces are interchangeable, so each tiling is reported once, as with MasterMatrix.
+ * Solutions are reported as lists of placements, starting with the fixed placements of the problem.
+ */
+template<typename Shape_T>
+class LazySolver
+{
+    LazySolver(LazySolver const&)=delete;
+    LazySolver& operator=(LazySolver const&)=delete;
+public:
+    typedef std::vector<FixedPlacement<Shape_T>> Solution;
+    /*! Receives each solution as it is found. Returning false stops the search.
+     */
+    typedef std::function<bool(Solution const&)> SolutionCallback;
+
+    static int const ShapeCount = static_cast<int>(Shape_T::END);
+
+public:
+    explicit LazySolver(ProblemInstance<Shape_T> const& problem)
+        :m_fieldSize(problem.getFieldSize()), m_remainingPieces{}, m_exactInventory(!problem.hasSurplusPieces()),
+         m_occupied(m_fieldSize.x * m_fieldSize.y, 0)
+    {
+        auto const& board = problem.getBoard();
+        for(int y = 0; y < m_fieldSize.y; ++y)
+        {
+            for(int x = 0; x < m_fieldSize.x; ++x)
+            {
+                if(!board.isOpen(x, y)) { m_occupied[y * m_fieldSize.x + x] = 1; }
+            }
+        }
+        for(auto const& s : problem.getPieces()) { ++m_remainingPieces[static_cast<int>(s)]; }
+        for(auto const& f : problem.getFixedPlacements())
+        {
+            place(f);
+            m_partialSolution.push_back(f);
+        }
+    }
+
+    Solution solve()
+    {
+        Solution ret;
+        solveAll([&ret](Solution const& solution) { ret = solution; return false; });
+        return ret;
+    }
+
+    void solveAll(SolutionCallback const& callback)
+    {
+        // every level of the search places one of the remaining pieces
+        int const n_remaining = std::accumulate(begin(m_remainingPieces), end(m_remainingPieces), 0);
+        m_statistics.reserveDepths(m_partialSolution.size() + n_remaining);
+        search(0, callback);
+        m_statistics.trimDepths();
+    }
+
+    /*! Work counters of the search. The implicit matrix is never relinked, so linkUpdates stays zero.
+     */
+    DLX::SearchStatistics const& getStatistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    void place(FixedPlacement<Shape_T> const& p)
+    {
+        for(auto const& c : getPlacement(p.shape, p.rotation).layout)
+        {
+            m_occupied[(p.y + c.y) * m_fieldSize.x + p.x + c.x] = 1;
+        }
+        --m_remainingPieces[static_cast<int>(p.shape)];
+    }
+
+    void remove(FixedPlacement<Shape_T> const& p)
+    {
+        for(auto const& c : getPlacement(p.shape, p.rotation).layout)
+        {
+            m_occupied[(p.y + c.y) * m_fieldSize.x + p.x + c.x] = 0;
+        }
+        ++m_remainingPieces[static_cast<int>(p.shape)];
+    }
+
+    bool fits(GenericPlacement<Shape_T> const& placement, int x, int y) const
+    {
+        if(x < 0 || y < 0 || x + placement.bound.x > m_fieldSize.x || y + placement.bound.y > m_fieldSize.y) {
+            return false;
+        }
+        for(auto const& c : placement.layout)
+        {
+            if(m_occupied[(y + c.y) * m_fieldSize.x + x + c.x]) { return false; }
+        }
+        return true;
+    }
+
+    typedef std::array<Shape_T, ShapeCount> ShapeOrder;
+
+    /* Remaining shapes in the order in which they are tried, the shapes with the most remaining pieces first.
+     * This keeps the inventory balanced, so that the search does not run out of the versatile shapes early.
+     * The order only changes when a piece is placed, so it is computed once per node of the search.
+     */
+    ShapeOrder getShapeOrder() const
+    {
+        ShapeOrder ret;
+        for(int i=0; i<ShapeCount; ++i) { ret[i] = static_cast<Shape_T>(i); }
+        std::stable_sort(begin(ret), end(ret), [this](Shape_T lhs, Shape_T rhs) {
+            return m_remainingPieces[static_cast<int>(lhs)] > m_remainingPieces[static_cast<int>(rhs)];
+        });
+        return ret;
+    }
+
+    /* Call f for every placement of a remaining piece that covers the given free cell, until f returns true.
+     * These are the rows of the cell's column. shape_order is the result of getShapeOrder() for the current node.
+     */
+    template<typename Func_T>
+    bool forEachCandidate(int cell, ShapeOrder const& shape_order, Func_T&& f) const
+    {
+        int const cell_x = cell % m_fieldSize.x;
+        int const cell_y = cell / m_fieldSize.x;
+        for(auto const s : shape_order)
+        {
+            if(m_remainingPieces[static_cast<int>(s)] == 0) { break; }
+            for(int rot=0; rot<getRotations(s); ++rot)
+            {
+                auto const& placement = getPlacement(s, rot);
+                for(auto const& anchor : placement.layout)
+                {
+                    int const x = cell_x - anchor.x;
+                    int const y = cell_y - anchor.y;
+                    if(fits(placement, x, y) && f(FixedPlacement<Shape_T>{ s, rot, x, y })) { return true; }
+                }
+            }
+        }
+        return false;
+    }
+
+    /* Call f for every placement of a shape on the free cells, until f returns true.
+     * These are the rows of the shape's column. Each placement is enumerated once, from its first cell,
+     * which cannot lie before the first free cell.
+     */
+    template<typename Func_T>
+    bool forEachPlacement(Shape_T s, int first_free, Func_T&& f) const
+    {
+        auto const area = static_cast<int>(m_occupied.size());
+        for(int cell = first_free; cell < area; ++cell)
+        {
+            if(m_occupied[cell]) { continue; }
+            int const cell_x = cell % m_fieldSize.x;
+            int const cell_y = cell / m_fieldSize.x;
+            for(int rot=0; rot<getRotations(s); ++rot)
+            {
+                auto const& placement = getPlacement(s, rot);
+                int const x = cell_x - placement.layout[0].x;
+                int const y = cell_y - placement.layout[0].y;
+                if(fits(placement, x, y) && f(FixedPlacement<Shape_T>{ s, rot, x, y })) { return true; }
+            }
+        }
+        return false;
+    }
+
+    // returns true if the callback requested the search to stop
+    bool search(int first_free, SolutionCallback const& callback)
+    {
+        auto const area = static_cast<int>(m_occupied.size());
+        while(first_free < area && m_occupied[first_free]) { ++first_free; }
+        auto const depth = m_partialSolution.size();
+        ++m_statistics.nodes;
+        ++m_statistics.nodesPerDepth[depth];
+        if(first_free == area)
+        {
+            ++m_statistics.solutions;
+            return !callback(m_partialSolution);
+        }
+
+        auto const shape_order = getShapeOrder();
+        // choose the column with the fewest rows, like the DLX search;
+        // of the cells, only those along the frontier of the filled area are examined
+        int const window = 2 * m_fieldSize.x;
+        int best_cell = -1;
+        int best_count = 0;
+        for(int cell = first_free, examined = 0; cell < area && examined < window; ++cell)
+        {
+            if(m_occupied[cell]) { continue; }
+            ++examined;
+            int count = 0;
+            int const limit = (best_cell == -1) ? area : best_count;
+            forEachCandidate(cell, shape_order, [&count, limit](FixedPlacement<Shape_T> const&) { return ++count >= limit; });
+            if(best_cell == -1 || count < best_count) {
+                best_cell = cell;
+                best_count = count;
+                // a cell that cannot be covered any more makes this branch a dead end
+                if(count <= 1) { break; }
+            }
+        }
+        if(best_count == 0) { return false; }
+
+        auto const recurse = [this, first_free, &callback](FixedPlacement<Shape_T> const& p) {
+            place(p);
+            m_partialSolution.push_back(p);
+            bool const stop = search(first_free, callback);
+            m_partialSolution.pop_back();
+            remove(p);
+            return stop;
+        };
+
+        if(m_exactInventory && best_count > 1) {
+            // with an exact inventory every piece has to be placed: a shape with fewer placements than
+            // remaining pieces is a dead end, and the last piece of a shape may be the better column
+            int best_shape = -1;
+            for(int i=0; i<ShapeCount; ++i)
+            {
+                if(m_remainingPieces[i] == 0) { continue; }
+                int const limit = std::max(m_remainingPieces[i], (m_remainingPieces[i] == 1) ? best_count : 0);
+                int count = 0;
+                forEachPlacement(static_cast<Shape_T>(i), first_free,
+                                 [&count, limit](FixedPlacement<Shape_T> const&) { return ++count >= limit; });
+                if(count < m_remainingPieces[i]) { return false; }
+                if(m_remainingPieces[i] == 1 && count < best_count) {
+                    best_shape = i;
+                    best_count = count;
+                }
+            }
+            if(best_shape != -1) { return forEachPlacement(static_cast<Shape_T>(best_shape), first_free, recurse); }
+        }
+        return forEachCandidate(best_cell, shape_order, recurse);
+    }
+
+private:
+    FieldSize const m_fieldSize;
+    std::array<int, ShapeCount> m_remainingPieces;
+    bool const m_exactInventory;
+    std::vector<char> m_occupied;           ///< per cell in row-major order, blocked cells count as occupied
+    Solution m_partialSolution;
+    DLX::SearchStatistics m_statistics;
+};
+
+}
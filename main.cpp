@@ -1,16 +1,32 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <functional>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <DLX.hpp>
+#include <census.hpp>
+#include <generated_solvers.hpp>
+#include <lazy_solver.hpp>
+#include <matrix_file.hpp>
+#include <perf_counters.hpp>
+#include <problem_file.hpp>
 #include <problem_instance.hpp>
+#include <puzzle_generator.hpp>
+#include <seam_counter.hpp>
+#include <solution_renderer.hpp>
+#include <solution_writer.hpp>
 #include <tetromino.hpp>
 
 void printField(Polyomino::FieldSize dim, int x, int y, Tetromino::OneSided::Placement const& placement)
@@ -56,42 +72,116 @@ void printShape(std::ostream& os, void const* s)
     os << "Piece " << *reinterpret_cast<Shape_T const*>(s) << " - ";
 }
 
-template<typename Shape_T>
-void printSolution(DLX::Matrix::Solution const& solution,
-                   Polyomino::ProblemInstance<Shape_T> const& problem, DLX::Matrix const& m)
+enum class OutputFormat
+{
+    Grid,
+    Ndjson,
+    Binary
+};
+
+struct SolverOptions
+{
+    bool printProblemMatrix = false;
+    bool computeAllSolutions = false;
+    OutputFormat outputFormat = OutputFormat::Grid;
+    bool perfCounters = false;
+    bool lazy = false;
+    bool preprocess = false;
+    bool generic = false;
+};
+
+/*! Stream for status messages, which must stay out of machine-readable output.
+ */
+std::ostream& getInfoStream(SolverOptions const& options)
 {
-    for(auto const& row : solution)
+    return (options.outputFormat == OutputFormat::Grid) ? std::cout : std::cerr;
+}
+
+void preprocessMatrix(DLX::Matrix& m, SolverOptions const& options)
+{
+    auto const statistics = m.preprocess();
+    getInfoStream(options) << "Preprocessing removed " << statistics.removedRows << " of " << m.getRowCount()
+                           << " rows and " << statistics.removedColumns << " columns (" << statistics.forcedRows
+                           << " forced rows, " << statistics.passes << " passes"
+                           << (statistics.infeasible ? ", no solution possible" : "") << ")." << std::endl;
+}
+
+/*! Hardware counters for the construction and the search phase, collected with --perf-counters.
+ * Only the solving thread is measured, so formatting and writing solutions is not included.
+ */
+struct PhaseCounters
+{
+    std::optional<DLX::PerfCounters> counters;
+    DLX::PerfCounters::Values construction;
+    DLX::PerfCounters::Values search;
+
+    explicit PhaseCounters(bool enabled)
     {
-        m.printRow(row, std::cout, problem.getCurrentPieceCount(),
-                   problem.getFieldSize().x, printShape<Shape_T>, false);
-        std::cout << "\n\n";
+        if(enabled) { counters.emplace(); }
+    }
+
+    void start()
+    {
+        if(counters) { counters->start(); }
+    }
+
+    void stop(DLX::PerfCounters::Values& phase)
+    {
+        if(counters) { phase = counters->stop(); }
     }
-}
+
+    void report(std::ostream& os, DLX::SearchStatistics const& statistics) const
+    {
+        if(!counters) { return; }
+        if(!counters->getError().empty()) { os << "Performance counters: " << counters->getError() << '\n'; }
+        DLX::printPerfCounters(os, "Construction", construction);
+        DLX::printPerfCounters(os, "Search", search);
+        os << "Search statistics: nodes " << statistics.nodes << ", link updates " << statistics.linkUpdates
+           << ", solutions " << statistics.solutions << '\n';
+        os << "Nodes per depth:";
+        for(auto const n : statistics.nodesPerDepth) { os << ' ' << n; }
+        os << std::endl;
+    }
+};
 
 template<typename Shape_T>
-void printSolutions(std::vector<DLX::Matrix::Solution> const& solutions,
-                    Polyomino::ProblemInstance<Shape_T> const& problem, DLX::Matrix const& m)
+std::unique_ptr<DLX::SolutionFormatter> createFormatter(OutputFormat format, DLX::Matrix const& m,
+                                                        Polyomino::BoardMask const& board, int pieceColumnCount)
 {
-    for(std::size_t i = 0; i < solutions.size(); ++i)
+    switch(format)
     {
-        std::cout << "\n *** Solution #" << i+1 << "/" << solutions.size() << ": ***\n" << std::endl;
-        auto const& solution = solutions[i];
-        printSolution(solution, problem, m);
+    case OutputFormat::Ndjson: return std::make_unique<Polyomino::NdjsonGridFormatter<Shape_T>>(m, board, pieceColumnCount);
+    case OutputFormat::Binary: return std::make_unique<DLX::BinaryFormatter>(m.getRowCount());
+    case OutputFormat::Grid: break;
     }
+    return std::make_unique<Polyomino::GridFormatter<Shape_T>>(m, board, pieceColumnCount);
 }
 
 template<typename Shape_T>
-void solveProblem(Polyomino::ProblemInstance<Shape_T> const& problem, bool computeAllSolutions = true)
+void solveProblem(Polyomino::ProblemInstance<Shape_T> const& problem, SolverOptions const& options)
 {
+    PhaseCounters phase_counters(options.perfCounters);
+    phase_counters.start();
     DLX::Matrix m = problem.calculateProblemMatrix();
-    if (computeAllSolutions) {
-        m.printMatrix(std::cout, problem.getCurrentPieceCount(), problem.getFieldSize().x, printShape<Shape_T>, true);
-        auto solutions = m.solveAll();
-        printSolutions(solutions, problem, m);
-    } else {
-        printSolution(m.solve(), problem, m);
+    phase_counters.stop(phase_counters.construction);
+    if (options.printProblemMatrix) {
+        m.printMatrix(std::cout, problem.getPieceColumnCount(), problem.getFieldSize().x, printShape<Shape_T>, true);
     }
-
+    if (options.preprocess) { preprocessMatrix(m, options); }
+    std::cout << std::flush;
+    // solutions are formatted and written on a separate thread while the search continues
+    DLX::SolutionWriter writer(createFormatter<Shape_T>(options.outputFormat, m, problem.getBoard(),
+                                                        problem.getPieceColumnCount()),
+                               stdout, problem.getCurrentPieceCount());
+    bool const compute_all = options.computeAllSolutions;
+    phase_counters.start();
+    m.solveAll([&writer, compute_all](DLX::Matrix::Solution const& solution) {
+        writer.push(solution);
+        return compute_all;
+    });
+    phase_counters.stop(phase_counters.search);
+    writer.finish();
+    phase_counters.report(std::cerr, m.getStatistics());
 }
 
 void green1()
@@ -102,7 +192,7 @@ void green1()
     problem.addPiece(Shape::J);
     problem.addPiece(Shape::Z);
 
-    solveProblem(problem);
+    solveProblem(problem, SolverOptions{ true, true });
 }
 
 void blueA3()
@@ -119,36 +209,109 @@ void blueA3()
     problem.addPiece(Shape::L);
     problem.addPiece(Shape::S);
 
-    solveProblem(problem);
+    solveProblem(problem, SolverOptions{ true, true });
 }
 
-void buildProblemFromString(int field_width, int field_height, std::string const& pieces)
+/*! Solve without building the problem matrix, see Polyomino::LazySolver.
+ */
+template<typename Shape_T>
+void solveProblemLazily(Polyomino::ProblemInstance<Shape_T> const& problem, SolverOptions const& options)
 {
-    if((field_width * field_height) != pieces.length() * 4) {
+    Polyomino::LazySolver<Shape_T> solver(problem);
+    Polyomino::SolutionRenderer<Shape_T> renderer(problem.getBoard(), problem.getPieceColumnCount());
+    std::uint64_t solution_index = 0;
+    bool const compute_all = options.computeAllSolutions;
+    solver.solveAll([&](typename Polyomino::LazySolver<Shape_T>::Solution const& solution) {
+        std::cout << "\n *** Solution #" << ++solution_index << ": ***\n\n" << renderer.render(solution) << '\n';
+        return compute_all;
+    });
+    if(solution_index == 0) { std::cout << "No solution.\n"; }
+    std::cout << std::flush;
+}
+
+/*! Solve with a solver generated at build time for the field size, see generated_solvers.hpp.
+ * Like the lazy solver, the generated solver reports each tiling once, regardless of identical pieces.
+ */
+void solveProblemGenerated(Tetromino::OneSided::GeneratedSolver solver,
+                           Tetromino::OneSided::ProblemDescription const& description, SolverOptions const& options)
+{
+    using namespace Tetromino::OneSided;
+    Polyomino::SolutionRenderer<Shape> renderer(description.board, static_cast<int>(description.pieces.size()));
+    std::uint64_t solution_index = 0;
+    bool const compute_all = options.computeAllSolutions;
+    solver(description.pieces, [&](std::vector<Polyomino::FixedPlacement<Shape>> const& solution) {
+        std::cout << "\n *** Solution #" << ++solution_index << ": ***\n\n" << renderer.render(solution) << '\n';
+        return compute_all;
+    });
+    if(solution_index == 0) { std::cout << "No solution.\n"; }
+    std::cout << std::flush;
+}
+
+/*! A generated solver applies to fields without blocked cells or fixed placements that the pieces fill
+ * exactly, and only writes grids, so problems with any other options go to the generic engine.
+ */
+Tetromino::OneSided::GeneratedSolver findGeneratedSolver(Tetromino::OneSided::ProblemDescription const& description,
+                                                         SolverOptions const& options)
+{
+    if(options.generic || options.lazy || options.outputFormat != OutputFormat::Grid || options.printProblemMatrix ||
+       options.perfCounters || options.preprocess) {
+        return nullptr;
+    }
+    auto const field_size = description.board.getFieldSize();
+    int const area = field_size.x * field_size.y;
+    if(!description.fixedPlacements.empty() || description.board.getOpenCellCount() != area ||
+       static_cast<int>(description.pieces.size()) * 4 != area) {
+        return nullptr;
+    }
+    return Tetromino::OneSided::findGeneratedSolver(field_size);
+}
+
+void solveProblemDescription(Tetromino::OneSided::ProblemDescription const& description, SolverOptions const& options)
+{
+    using namespace Tetromino::OneSided;
+    if(description.board.getOpenCellCount() % 4 != 0) {
+        std::cout << "The open cells of the field cannot be filled with tetrominoes" << std::endl;
+        return;
+    }
+    if(description.board.getOpenCellCount() > static_cast<int>(description.pieces.size()) * 4) {
         std::cout << "Not enough pieces to fill the field" << std::endl;
         return;
     }
+    if(auto const solver = findGeneratedSolver(description, options)) {
+        solveProblemGenerated(solver, description, options);
+        return;
+    }
+    Polyomino::ProblemInstance<Shape> problem(description.board);
+    if(!addPieces(problem, description)) {
+        std::cout << "Invalid fixed placement" << std::endl;
+        return;
+    }
+    if(options.lazy) {
+        solveProblemLazily(problem, options);
+    } else {
+        solveProblem(problem, options);
+    }
+}
+
+void buildProblemFromString(int field_width, int field_height, std::string const& pieces, SolverOptions const& options)
+{
+    if(field_width <= 0 || field_height <= 0) {
+        std::cout << "Invalid field size" << std::endl;
+        return;
+    }
 
     using namespace Tetromino::OneSided;
-    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{field_width, field_height});
-    for(char c : pieces)
-    {
-        switch(c)
-        {
-        case 'i': case 'I': problem.addPiece(Shape::I); break;
-        case 'o': case 'O': problem.addPiece(Shape::O); break;
-        case 't': case 'T': problem.addPiece(Shape::T); break;
-        case 'j': case 'J': problem.addPiece(Shape::J); break;
-        case 'l': case 'L': problem.addPiece(Shape::L); break;
-        case 's': case 'S': problem.addPiece(Shape::S); break;
-        case 'z': case 'Z': problem.addPiece(Shape::Z); break;
-        default: std::cout << "Unknown shape \'" << c << "\'" << std::endl; return;
-        }
+    ProblemDescription description{ Polyomino::FieldSize{field_width, field_height}, {},
+                                    Polyomino::BoardMask(Polyomino::FieldSize{field_width, field_height}), {} };
+    char error_char;
+    if(!parsePieces(pieces, description.pieces, error_char)) {
+        std::cout << "Unknown shape \'" << error_char << "\'" << std::endl;
+        return;
     }
-    solveProblem(problem, false);
+    solveProblemDescription(description, options);
 }
 
-void readProblemFromFile(std::string const& filename)
+void readProblemFromFile(std::string const& filename, SolverOptions const& options)
 {
     std::ifstream fin(filename);
     if(!fin) {
@@ -156,88 +319,342 @@ void readProblemFromFile(std::string const& filename)
         std::exit(1);
     }
 
-    int field_width, field_height;
-    fin >> field_width;
-    fin >> field_height;
-
-    std::string pieces;
-    fin >> pieces;
-    buildProblemFromString(field_width, field_height, pieces);
+    Tetromino::OneSided::ProblemDescription description;
+    if(!Tetromino::OneSided::readProblemDescription(fin, description)) {
+        std::cerr << "Invalid problem file: " << filename << std::endl;
+        std::exit(1);
+    }
+    solveProblemDescription(description, options);
 }
 
-int main(int argc, char* argv[])
+/*! Formats solutions of a raw matrix as the 0/1 rows of the matrix they consist of.
+ */
+class SparseRowFormatter : public DLX::SolutionFormatter
 {
-    //*
-    if(argc != 2 && argc != 4)
-    {
-        std::cout << "Usage: \n"
-                  << "  tetromino_solver w h IOTJLSZ\n"
-                  << " or\n"
-                  << "  tetromino_solver <filename>\n"
-                  << std::endl;
-    } else if(argc == 2)
-    {
-        readProblemFromFile(argv[1]);
-    } else if(argc == 4)
+public:
+    explicit SparseRowFormatter(DLX::SparseMatrix const& sparse)
+        :m_sparse(sparse)
+    {}
+
+    void format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer) override
     {
-        buildProblemFromString( std::atoi(argv[1]), std::atoi(argv[2]), argv[3]);
+        buffer += "Solution #";
+        buffer += std::to_string(solution_index);
+        buffer += '\n';
+        for(int i=0; i<n_rows; ++i)
+        {
+            auto const first = buffer.size();
+            buffer.append(m_sparse.nColumns, '0');
+            for(auto j = m_sparse.rowOffsets[rows[i]]; j < m_sparse.rowOffsets[rows[i] + 1]; ++j)
+            {
+                buffer[first + m_sparse.columnIndices[j]] = '1';
+            }
+            buffer += '\n';
+        }
+        buffer += '\n';
     }
-    /*/
-    if(argc != 2) { std::cout << "No file." << std::endl; return 1; }
-    std::fstream fin(argv[1]);
-    std::string tmp;
-    std::vector<std::string> mat_str;
-    while (std::getline(fin, tmp)) {
-        mat_str.push_back(tmp);
+
+private:
+    DLX::SparseMatrix const& m_sparse;
+};
+
+int solveMatrixFile(std::string const& filename, SolverOptions const& options)
+{
+    std::ostream& info = getInfoStream(options);
+    PhaseCounters phase_counters(options.perfCounters);
+    auto const t_load_start = std::chrono::steady_clock::now();
+    phase_counters.start();
+    DLX::MatrixFile matrix_file;
+    std::string error;
+    if(!matrix_file.load(filename, error)) {
+        std::cerr << error << std::endl;
+        return 1;
     }
-    int const n_cols = static_cast<int>(mat_str.front().length());
-    if(!std::all_of(begin(mat_str), end(mat_str), [=](std::string const& s) { return s.length() == n_cols; }))
+    auto const& sparse = matrix_file.getMatrix();
+    DLX::Matrix m = DLX::createMatrix(sparse);
+    phase_counters.stop(phase_counters.construction);
+    auto const t_load_end = std::chrono::steady_clock::now();
+    info << "Problem matrix " << sparse.nRows << "x" << sparse.nColumns << "." << std::endl;
+    if(options.preprocess) { preprocessMatrix(m, options); }
+
+    info << "Calculating solution..." << std::endl;
+    std::unique_ptr<DLX::SolutionFormatter> formatter;
+    switch(options.outputFormat)
     {
+    case OutputFormat::Grid:   formatter = std::make_unique<SparseRowFormatter>(sparse); break;
+    case OutputFormat::Ndjson: formatter = std::make_unique<DLX::NdjsonFormatter>(); break;
+    case OutputFormat::Binary: formatter = std::make_unique<DLX::BinaryFormatter>(sparse.nRows); break;
+    }
+    auto const t_start = std::chrono::steady_clock::now();
+    DLX::SolutionWriter writer(std::move(formatter), stdout, std::min(sparse.nRows, sparse.nColumns));
+    phase_counters.start();
+    m.solveAll([&writer](DLX::Matrix::Solution const& solution) { writer.push(solution); return true; });
+    phase_counters.stop(phase_counters.search);
+    writer.finish();
+    auto const t_end = std::chrono::steady_clock::now();
+
+    info << "Found " << writer.getSolutionCount() << " solutions." << std::endl;
+    info << "Load time: "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(t_load_end - t_load_start).count() << "ms."
+         << std::endl;
+    info << "Compute time: "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count() << "ms."
+         << std::endl;
+    phase_counters.report(info, m.getStatistics());
+    return 0;
+}
+
+int compileMatrixFile(std::string const& input_filename, std::string const& output_filename)
+{
+    DLX::MatrixFile matrix_file;
+    std::string error;
+    if(!matrix_file.load(input_filename, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if(!DLX::writeBinaryMatrix(matrix_file.getMatrix(), output_filename)) {
+        std::cerr << "File could not be written: " << output_filename << std::endl;
         return 1;
     }
-    std::cout << "Problem matrix " << mat_str.size() << "x" << n_cols << "." << std::endl;
+    return 0;
+}
 
-    DLX::Matrix m(n_cols);
-    for(auto const& row_str : mat_str)
+/*! Print the number of tilings of a w x h field for every piece multiset, one multiset per line.
+ */
+int runCensus(int field_width, int field_height, int n_threads)
+{
+    if(field_width <= 0 || field_height <= 0 || n_threads <= 0) {
+        std::cerr << "Invalid field size or thread count" << std::endl;
+        return 1;
+    }
+    using Tetromino::OneSided::Shape;
+    auto const t_start = std::chrono::steady_clock::now();
+    Polyomino::Census<Shape> census(Polyomino::FieldSize{ field_width, field_height });
+    census.run(n_threads);
+    auto const t_end = std::chrono::steady_clock::now();
+
+    for(auto const& [counts, n] : census.getTable())
     {
-        DLX::RowHeader rh;
-        rh.UserData = &row_str;
-        std::vector<int> fields;
-        for(int i=0; i<row_str.size(); ++i)
+        for(int i=0; i<Polyomino::Census<Shape>::ShapeCount; ++i)
         {
-            if(row_str[i] == '1') {
-                fields.push_back(i);
-            } else if(row_str[i] != '0') {
-                return 1;
-            }
+            for(int j=0; j<counts[i]; ++j) { std::cout << static_cast<Shape>(i); }
         }
-        m.addRow(rh, fields);
+        std::cout << ' ' << n << '\n';
     }
+    std::cout << std::flush;
+    std::cerr << "Found " << census.getTilingCount() << " tilings for " << census.getTable().size() << " multisets."
+              << std::endl;
+    std::cerr << "Compute time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count() << "ms." << std::endl;
+    return 0;
+}
 
-    m.printMatrix(std::cout, n_cols, 0, DLX::RowHeaderUserDataPrinter(), true);
+/*! Print the number of tilings of a w x h field by a piece multiset, counted by joining the tilings of the
+ * two halves of the field, see Polyomino::SeamCounter.
+ */
+int runSeamCount(int field_width, int field_height, std::string const& pieces, int n_threads)
+{
+    if(field_width <= 0 || field_height <= 0 || n_threads <= 0 || (field_width < 2 && field_height < 2)) {
+        std::cerr << "Invalid field size or thread count" << std::endl;
+        return 1;
+    }
+    using namespace Tetromino::OneSided;
+    std::vector<Shape> shapes;
+    char error_char;
+    if(!parsePieces(pieces, shapes, error_char)) {
+        std::cerr << "Unknown shape \'" << error_char << "\'" << std::endl;
+        return 1;
+    }
+    if(static_cast<int>(shapes.size()) * 4 != field_width * field_height) {
+        std::cerr << "Pieces must fill the field exactly" << std::endl;
+        return 1;
+    }
+    auto const t_start = std::chrono::steady_clock::now();
+    Polyomino::SeamCounter<Shape> counter(Polyomino::FieldSize{ field_width, field_height });
+    auto const n = counter.count(shapes, n_threads);
+    auto const t_end = std::chrono::steady_clock::now();
 
+    std::cout << n << std::endl;
+    auto const seam = counter.getSeam();
+    auto const& statistics = counter.getStatistics();
+    std::cerr << "Seam after " << (seam.horizontal ? "row " : "column ") << seam.position << ", "
+              << statistics.crossingPlacements << " crossing placements." << std::endl;
+    for(int side=0; side<2; ++side)
+    {
+        std::cerr << "Side " << side + 1 << ": " << statistics.partialTilings[side] << " tilings, "
+                  << statistics.keys[side] << " keys." << std::endl;
+    }
+    std::cerr << "Search statistics: nodes " << statistics.search.nodes << ", link updates "
+              << statistics.search.linkUpdates << std::endl;
+    std::cerr << "Compute time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count() << "ms." << std::endl;
+    return 0;
+}
+
+/*! Generate puzzles with a unique solution and write each one to a file in output_dir.
+ */
+int generatePuzzles(int count, int min_side, int max_side, std::string const& output_dir, int n_threads)
+{
+    if(count <= 0 || min_side <= 0 || max_side < min_side || n_threads <= 0) {
+        std::cerr << "Invalid puzzle count, field size range or thread count" << std::endl;
+        return 1;
+    }
+    bool has_area = false;
+    for(int x = min_side; x <= max_side; ++x)
+    {
+        for(int y = x; y <= max_side; ++y) { has_area = has_area || (x * y) % 4 == 0; }
+    }
+    if(!has_area) {
+        std::cerr << "No field size in range can be filled with tetrominoes" << std::endl;
+        return 1;
+    }
+    using namespace Tetromino::OneSided;
+    std::error_code ec;
+    std::filesystem::create_directories(output_dir, ec);
+    if(ec) {
+        std::cerr << "Output directory could not be created: " << output_dir << std::endl;
+        return 1;
+    }
 
-    std::cout << "Calculating solution..." << std::endl;
     auto const t_start = std::chrono::steady_clock::now();
-    auto solutions = m.solveAll();
+    Polyomino::PuzzleGenerator<Shape> generator(min_side, max_side, std::random_device()());
+    auto const puzzles = generator.generate(count, n_threads);
     auto const t_end = std::chrono::steady_clock::now();
 
-    std::cout << "Found " << solutions.size() << " solutions:" << std::endl;
-    int i = 0;
-    for(auto const solution : solutions)
+    for(auto const& puzzle : puzzles)
     {
-        std::cout << "Solution #" << ++i << '\n';
-        for(auto const& s : solution)
-        {
-            std::cout << mat_str[s] << '\n';
+        ProblemDescription description{ puzzle.fieldSize, puzzle.pieces, Polyomino::BoardMask(puzzle.fieldSize), {} };
+        std::ostringstream name;
+        name << "gen_" << puzzle.fieldSize.x << "x" << puzzle.fieldSize.y << "_";
+        for(auto const& s : puzzle.pieces) { name << s; }
+        name << ".txt";
+        auto const filename = std::filesystem::path(output_dir) / name.str();
+        std::ofstream fout(filename);
+        writeProblemDescription(fout, description);
+        if(!fout) {
+            std::cerr << "File could not be written: " << filename.string() << std::endl;
+            return 1;
         }
-        std::cout << '\n';
+        std::cout << filename.string() << '\n';
     }
-    std::cout << '\n' << std::endl;
+    std::cout << std::flush;
 
-    std::cout << "Compute time: "
-              << std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count() << "ms."
-              << std::endl;
+    auto const& statistics = generator.getStatistics();
+    double const seconds = std::chrono::duration<double>(t_end - t_start).count();
+    std::cerr << "Generated " << puzzles.size() << " puzzles from " << statistics.candidates << " candidates ("
+              << statistics.unsolvable << " unsolvable, " << statistics.ambiguous << " ambiguous, "
+              << statistics.duplicates << " duplicates)." << std::endl;
+    std::cerr << "Compute time: " << static_cast<long long>(seconds * 1000) << "ms, "
+              << ((seconds > 0) ? puzzles.size() / seconds : 0.0) << " puzzles/s, "
+              << ((seconds > 0) ? statistics.candidates / seconds : 0.0) << " candidates/s." << std::endl;
+    return 0;
+}
 
-    */
+int main(int argc, char* argv[])
+{
+    SolverOptions options;
+    std::vector<char*> args(argv, argv + argc);
+    auto const take_flag = [&args](char const* flag) {
+        auto it = std::find_if(args.begin() + 1, args.end(), [flag](char const* a) { return std::strcmp(a, flag) == 0; });
+        if(it == args.end()) { return false; }
+        args.erase(it);
+        return true;
+    };
+    options.printProblemMatrix = take_flag("--print-matrix");
+    options.computeAllSolutions = take_flag("--all");
+    options.perfCounters = take_flag("--perf-counters");
+    options.lazy = take_flag("--lazy");
+    options.preprocess = take_flag("--preprocess");
+    options.generic = take_flag("--generic");
+    auto const format_it = std::find_if(args.begin() + 1, args.end(), [](char const* a) { return std::strcmp(a, "--format") == 0; });
+    if(format_it != args.end()) {
+        std::string const format = (format_it + 1 != args.end()) ? *(format_it + 1) : "";
+        if(format == "grid") {
+            options.outputFormat = OutputFormat::Grid;
+        } else if(format == "ndjson") {
+            options.outputFormat = OutputFormat::Ndjson;
+        } else if(format == "binary") {
+            options.outputFormat = OutputFormat::Binary;
+        } else {
+            std::cerr << "Unknown output format \'" << format << "\'" << std::endl;
+            return 1;
+        }
+        args.erase(format_it, format_it + 2);
+    }
+    int n_threads = 1;
+    auto const threads_it = std::find_if(args.begin() + 1, args.end(), [](char const* a) { return std::strcmp(a, "--threads") == 0; });
+    if(threads_it != args.end()) {
+        n_threads = (threads_it + 1 != args.end()) ? std::atoi(*(threads_it + 1)) : 0;
+        if(n_threads <= 0) {
+            std::cerr << "Invalid thread count" << std::endl;
+            return 1;
+        }
+        args.erase(threads_it, threads_it + 2);
+    }
+    if(options.lazy && (options.outputFormat != OutputFormat::Grid || options.printProblemMatrix || options.perfCounters ||
+                         options.preprocess)) {
+        std::cerr << "--lazy builds no problem matrix and only supports grid output" << std::endl;
+        return 1;
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+
+    if(argc == 3 && std::strcmp(argv[1], "--matrix") == 0)
+    {
+        return solveMatrixFile(argv[2], options);
+    } else if(argc == 4 && std::strcmp(argv[1], "--census") == 0)
+    {
+        return runCensus(std::atoi(argv[2]), std::atoi(argv[3]), n_threads);
+    } else if(argc == 5 && std::strcmp(argv[1], "--seam-count") == 0)
+    {
+        return runSeamCount(std::atoi(argv[2]), std::atoi(argv[3]), argv[4], n_threads);
+    } else if(argc == 6 && std::strcmp(argv[1], "--generate") == 0)
+    {
+        return generatePuzzles(std::atoi(argv[2]), std::atoi(argv[3]), std::atoi(argv[4]), argv[5], n_threads);
+    } else if(argc == 4 && std::strcmp(argv[1], "--compile-matrix") == 0)
+    {
+        return compileMatrixFile(argv[2], argv[3]);
+    } else if(argc == 2)
+    {
+        readProblemFromFile(argv[1], options);
+    } else if(argc == 4)
+    {
+        buildProblemFromString( std::atoi(argv[1]), std::atoi(argv[2]), argv[3], options);
+    } else
+    {
+        std::cout << "Usage: \n"
+                  << "  tetromino_solver [options] w h IOTJLSZ\n"
+                  << "    (the pieces may exceed the field area, any subset filling the field is a solution)\n"
+                  << " or\n"
+                  << "  tetromino_solver [options] <filename>\n"
+                  << " or\n"
+                  << "  tetromino_solver --matrix <matrix_file>\n"
+                  << "    (solve a raw exact cover matrix, either as text of 0/1 rows or in compiled binary form)\n"
+                  << " or\n"
+                  << "  tetromino_solver --compile-matrix <matrix.txt> <matrix.bin>\n"
+                  << " or\n"
+                  << "  tetromino_solver [--threads <n>] --census w h\n"
+                  << "    (count the tilings of a w x h field for every piece multiset that has any, in one search)\n"
+                  << " or\n"
+                  << "  tetromino_solver [--threads <n>] --seam-count w h IOTJLSZ\n"
+                  << "    (count the tilings of a w x h field by exactly the given pieces, by cutting the field in\n"
+                  << "     half and joining the tilings of both halves)\n"
+                  << " or\n"
+                  << "  tetromino_solver [--threads <n>] --generate <count> <min_side> <max_side> <output_dir>\n"
+                  << "    (generate puzzles on random fields and piece sets that have a unique solution up to\n"
+                  << "     rotating and mirroring the field, written to output_dir in the problem file format)\n"
+                  << "\n"
+                  << "Options:\n"
+                  << "  --all             enumerate all solutions instead of stopping at the first one\n"
+                  << "  --print-matrix    print the problem matrix before solving\n"
+                  << "  --format <fmt>    output format for solutions: grid (default), ndjson or binary\n"
+                  << "  --perf-counters   report hardware performance counters for matrix construction and search\n"
+                  << "  --preprocess      remove rows that cannot be part of any solution before searching\n"
+                  << "  --threads <n>     number of threads for --census, --seam-count and --generate (default 1)\n"
+                  << "  --lazy            search without building the problem matrix, for large boards;\n"
+                  << "                    identical pieces are interchangeable, so each tiling is reported once\n"
+                  << "  --generic         always use the generic engine, even if a specialized solver was\n"
+                  << "                    generated for the field size at build time\n"
+                  << std::endl;
+    }
 }
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <exceptions.hpp>
+#include <polyomino.hpp>
+#include <problem_instance.hpp>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! Problem matrix containing every placement of every shape on a field of a given size exactly once.
+ * The matrix has one secondary column per shape, followed by one primary column per cell of the field.
+ * It is built once per field size and reused for all queries on that size: a query applies its piece
+ * multiset by setting the multiplicity of each used shape column and deactivating the columns of unused
+ * shapes, and restores the master state when done.
+ *
+ * Since copies of the same shape are indistinguishable here, each tiling is reported once, whereas
+ * ProblemInstance reports it once for every permutation of identical pieces of an exact inventory.
+ *
+ * A MasterMatrix is modified during a query and must not be shared between threads.
+ */
+template<typename Shape_T>
+class MasterMatrix
+{
+    MasterMatrix(MasterMatrix const&)=delete;
+    MasterMatrix& operator=(MasterMatrix const&)=delete;
+public:
+    struct PlacementRecord
+    {
+        Shape_T shape;          // must remain the first member, see printShape()
+        int rotation;
+        int x;
+        int y;
+    };
+
+    static int const ShapeCount = static_cast<int>(Shape_T::END);
+
+public:
+    MasterMatrix(FieldSize const& field_size)
+        :m_fieldSize(field_size),
+         m_matrix(ShapeCount + field_size.x * field_size.y, countPlacements(field_size),
+                  static_cast<std::size_t>(countPlacements(field_size)) * (Degree<Shape_T>::value + 1))
+    {
+        buildMatrix();
+    }
+
+    /*! Get the master matrix for a field size, building it on first use.
+     * The cache is per thread, so that concurrent queries never share a matrix.
+     */
+    static MasterMatrix& getCached(FieldSize const& field_size)
+    {
+        static thread_local std::map<std::pair<int, int>, std::unique_ptr<MasterMatrix>> cache;
+        auto& entry = cache[std::make_pair(field_size.x, field_size.y)];
+        if(!entry) { entry = std::make_unique<MasterMatrix>(field_size); }
+        return *entry;
+    }
+
+    std::vector<DLX::Matrix::Solution> solveAll(std::vector<Shape_T> const& pieces)
+    {
+        ActivePieces active_pieces(*this, pieces);
+        return m_matrix.solveAll();
+    }
+
+    /*! Enumerate the tilings for a piece multiset without collecting them, see DLX::Matrix::solveAll().
+     */
+    void solveAll(std::vector<Shape_T> const& pieces, DLX::Matrix::SolutionCallback const& callback)
+    {
+        ActivePieces active_pieces(*this, pieces);
+        m_matrix.solveAll(callback);
+    }
+
+    std::vector<DLX::Matrix::Solution> solveUpTo(std::vector<Shape_T> const& pieces, std::size_t n)
+    {
+        ActivePieces active_pieces(*this, pieces);
+        return m_matrix.solveUpTo(n);
+    }
+
+    DLX::Matrix::Solution solve(std::vector<Shape_T> const& pieces)
+    {
+        ActivePieces active_pieces(*this, pieces);
+        return m_matrix.solve();
+    }
+
+    PlacementRecord const& getPlacementRecord(int rowIndex) const
+    {
+        return m_placements.at(rowIndex);
+    }
+
+    FieldSize getFieldSize() const
+    {
+        return m_fieldSize;
+    }
+
+    /*! Column of the matrix for a cell of the field. The column of a shape is its index in Shape_T, so
+     * DLX::SearchState::getRemaining() on it is the number of pieces of that shape still to be placed.
+     */
+    int getCellColumn(int x, int y) const
+    {
+        return ShapeCount + y * m_fieldSize.x + x;
+    }
+
+    DLX::Matrix const& getMatrix() const
+    {
+        return m_matrix;
+    }
+
+private:
+    /*! Applies a piece multiset to the master matrix for the lifetime of the object.
+     */
+    class ActivePieces
+    {
+        ActivePieces(ActivePieces const&)=delete;
+        ActivePieces& operator=(ActivePieces const&)=delete;
+    public:
+        ActivePieces(MasterMatrix& master, std::vector<Shape_T> const& pieces)
+            :m_master(master)
+        {
+            auto const field_area = master.m_fieldSize.x * master.m_fieldSize.y;
+            if(static_cast<int>(pieces.size()) * Degree<Shape_T>::value != field_area) {
+                PROTOCOL_VIOLATION("Piece area does not match field size");
+            }
+            std::array<int, ShapeCount> shape_counts{};
+            for(auto const& s : pieces) { ++shape_counts[static_cast<int>(s)]; }
+            for(int i=0; i<ShapeCount; ++i)
+            {
+                if(shape_counts[i] == 0) {
+                    master.m_matrix.deactivateColumn(i);
+                } else {
+                    master.m_matrix.setColumnMultiplicity(i, shape_counts[i]);
+                }
+            }
+        }
+
+        ~ActivePieces()
+        {
+            m_master.m_matrix.reactivateColumns();
+        }
+
+    private:
+        MasterMatrix& m_master;
+    };
+
+    static int countPlacements(FieldSize const& field_size)
+    {
+        int ret = 0;
+        for(int i=0; i<ShapeCount; ++i)
+        {
+            auto const s = static_cast<Shape_T>(i);
+            for(int rot=0; rot<getRotations(s); ++rot)
+            {
+                auto const placement = getPlacement(s, rot);
+                ret += std::max(field_size.x - placement.bound.x + 1, 0) *
+                       std::max(field_size.y - placement.bound.y + 1, 0);
+            }
+        }
+        return ret;
+    }
+
+    void buildMatrix()
+    {
+        // row headers point into m_placements, which therefore must never reallocate
+        m_placements.reserve(countPlacements(m_fieldSize));
+
+        std::array<int, Degree<Shape_T>::value + 1> occupied_fields;
+        for(int i=0; i<ShapeCount; ++i)
+        {
+            auto const s = static_cast<Shape_T>(i);
+            for(int rot=0; rot<getRotations(s); ++rot)
+            {
+                auto const placement = getPlacement(s, rot);
+                std::array<int, Degree<Shape_T>::value> cell_offsets;
+                std::transform(begin(placement.layout), end(placement.layout), begin(cell_offsets),
+                               [this](auto const& p) { return p.y * m_fieldSize.x + p.x; });
+                std::sort(begin(cell_offsets), end(cell_offsets));
+                for(int x = 0; x < (m_fieldSize.x - placement.bound.x + 1); ++x)
+                {
+                    for(int y = 0; y < (m_fieldSize.y - placement.bound.y + 1); ++y)
+                    {
+                        m_placements.push_back(PlacementRecord{ s, rot, x, y });
+                        DLX::RowHeader row_header;
+                        row_header.UserData = &m_placements.back();
+
+                        int const origin = ShapeCount + y * m_fieldSize.x + x;
+                        occupied_fields[0] = i;
+                        for(std::size_t j=0; j<cell_offsets.size(); ++j)
+                        {
+                            occupied_fields[j + 1] = origin + cell_offsets[j];
+                        }
+                        m_matrix.addRow(row_header, occupied_fields.data(), static_cast<int>(occupied_fields.size()));
+                    }
+                }
+            }
+        }
+        for(int i=0; i<ShapeCount; ++i) { m_matrix.setColumnMultiplicity(i, 1); }
+        m_matrix.optimizeLayout(ShapeCount);
+    }
+
+private:
+    FieldSize const m_fieldSize;
+    std::vector<PlacementRecord> m_placements;
+    DLX::Matrix m_matrix;
+};
+
+}
@@ -0,0 +1,213 @@
+#include <matrix_file.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define DLX_HAS_MMAP 1
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace DLX
+{
+namespace
+{
+char const BinaryMagic[8] = { 'D', 'L', 'X', 'C', 'S', 'R', '0', '1' };
+
+struct BinaryHeader
+{
+    char magic[8];
+    std::uint32_t nColumns;
+    std::uint32_t nRows;
+    std::uint64_t nNonZeros;
+};
+static_assert(sizeof(BinaryHeader) == 24, "Binary matrix header must not contain padding");
+
+// counts and offsets are handed to Matrix as int
+std::uint64_t const MaxMatrixSize = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+}
+
+MappedFile::MappedFile()
+    :m_data(nullptr), m_size(0), m_isMapped(false)
+{}
+
+MappedFile::~MappedFile()
+{
+#ifdef DLX_HAS_MMAP
+    if(m_isMapped) { munmap(const_cast<char*>(m_data), m_size); }
+#endif
+}
+
+bool MappedFile::open(std::string const& filename)
+{
+#ifdef DLX_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0) { return false; }
+    struct stat st;
+    if(fstat(fd, &st) != 0) { ::close(fd); return false; }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if(m_size > 0) {
+        void* mem = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mem == MAP_FAILED) { ::close(fd); return false; }
+        // the file is parsed front to back exactly once
+        madvise(mem, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<char const*>(mem);
+        m_isMapped = true;
+    }
+    ::close(fd);
+    return true;
+#else
+    std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+    if(!fin) { return false; }
+    m_buffer.resize(static_cast<std::size_t>(fin.tellg()));
+    fin.seekg(0);
+    if(!fin.read(m_buffer.data(), m_buffer.size())) { return false; }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+#endif
+}
+
+MatrixFile::MatrixFile()
+    :m_isBinary(false)
+{}
+
+bool MatrixFile::load(std::string const& filename, std::string& error)
+{
+    if(!m_file.open(filename)) {
+        error = "File could not be opened: " + filename;
+        return false;
+    }
+    m_isBinary = (m_file.size() >= sizeof(BinaryMagic)) &&
+                 (std::memcmp(m_file.data(), BinaryMagic, sizeof(BinaryMagic)) == 0);
+    return m_isBinary ? parseBinary(error) : parseText(error);
+}
+
+bool MatrixFile::parseText(std::string& error)
+{
+    char const* it = m_file.data();
+    char const* const end = it + m_file.size();
+    int n_columns = -1;
+    int line = 0;
+    m_rowOffsets.assign(1, 0);
+    while(it != end)
+    {
+        ++line;
+        int column = 0;
+        for(; it != end && *it != '\n' && *it != '\r'; ++it, ++column)
+        {
+            if(static_cast<std::uint64_t>(column) == MaxMatrixSize) {
+                error = "Line " + std::to_string(line) + " has too many columns";
+                return false;
+            }
+            if(*it == '1') {
+                m_columnIndices.push_back(column);
+            } else if(*it != '0') {
+                error = "Invalid character in line " + std::to_string(line);
+                return false;
+            }
+        }
+        if(it != end && *it == '\r') { ++it; }
+        if(it != end && *it == '\n') { ++it; }
+        if(column == 0) { continue; }   // skip empty lines
+        if(n_columns == -1) {
+            n_columns = column;
+        } else if(column != n_columns) {
+            error = "Line " + std::to_string(line) + " has " + std::to_string(column) + " columns, expected " +
+                    std::to_string(n_columns);
+            return false;
+        }
+        if(m_columnIndices.size() > MaxMatrixSize || m_rowOffsets.size() > MaxMatrixSize) {
+            error = "Matrix is too large in line " + std::to_string(line);
+            return false;
+        }
+        m_rowOffsets.push_back(static_cast<std::uint32_t>(m_columnIndices.size()));
+    }
+    if(n_columns == -1) {
+        error = "Matrix file is empty";
+        return false;
+    }
+    m_matrix.nColumns = n_columns;
+    m_matrix.nRows = static_cast<int>(m_rowOffsets.size()) - 1;
+    m_matrix.rowOffsets = m_rowOffsets.data();
+    m_matrix.columnIndices = m_columnIndices.data();
+    return true;
+}
+
+bool MatrixFile::parseBinary(std::string& error)
+{
+    if(m_file.size() < sizeof(BinaryHeader)) {
+        error = "Truncated binary matrix header";
+        return false;
+    }
+    BinaryHeader header;
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if(header.nRows > MaxMatrixSize || header.nColumns > MaxMatrixSize || header.nNonZeros > MaxMatrixSize) {
+        error = "Binary matrix is too large";
+        return false;
+    }
+    std::uint64_t const expected_size = sizeof(BinaryHeader) +
+        (static_cast<std::uint64_t>(header.nRows) + 1 + header.nNonZeros) * sizeof(std::uint32_t);
+    if(m_file.size() != expected_size) {
+        error = "Binary matrix file size does not match its header";
+        return false;
+    }
+    auto const row_offsets = reinterpret_cast<std::uint32_t const*>(m_file.data() + sizeof(BinaryHeader));
+    auto const column_indices = row_offsets + header.nRows + 1;
+    if(row_offsets[0] != 0 || row_offsets[header.nRows] != header.nNonZeros) {
+        error = "Invalid row offsets in binary matrix";
+        return false;
+    }
+    for(std::uint32_t i=0; i<header.nRows; ++i)
+    {
+        if(row_offsets[i] > row_offsets[i + 1]) {
+            error = "Invalid row offsets in binary matrix";
+            return false;
+        }
+    }
+    for(std::uint32_t i=0; i<header.nNonZeros; ++i)
+    {
+        if(column_indices[i] >= header.nColumns) {
+            error = "Invalid column index in binary matrix";
+            return false;
+        }
+    }
+    m_matrix.nColumns = static_cast<int>(header.nColumns);
+    m_matrix.nRows = static_cast<int>(header.nRows);
+    m_matrix.rowOffsets = row_offsets;
+    m_matrix.columnIndices = column_indices;
+    return true;
+}
+
+bool writeBinaryMatrix(SparseMatrix const& sparse, std::string const& filename)
+{
+    std::ofstream fout(filename, std::ios::binary);
+    if(!fout) { return false; }
+    BinaryHeader header;
+    std::memcpy(header.magic, BinaryMagic, sizeof(BinaryMagic));
+    header.nColumns = static_cast<std::uint32_t>(sparse.nColumns);
+    header.nRows = static_cast<std::uint32_t>(sparse.nRows);
+    header.nNonZeros = sparse.rowOffsets[sparse.nRows];
+    fout.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<char const*>(sparse.rowOffsets), (sparse.nRows + 1) * sizeof(std::uint32_t));
+    fout.write(reinterpret_cast<char const*>(sparse.columnIndices), header.nNonZeros * sizeof(std::uint32_t));
+    return static_cast<bool>(fout);
+}
+
+Matrix createMatrix(SparseMatrix const& sparse, bool use_huge_pages)
+{
+    Matrix ret(sparse.nColumns, sparse.nRows, sparse.rowOffsets[sparse.nRows], use_huge_pages);
+    static_assert(sizeof(int) == sizeof(std::uint32_t), "Column indices are passed to addRow without conversion");
+    for(int i=0; i<sparse.nRows; ++i)
+    {
+        auto const first = sparse.rowOffsets[i];
+        auto const last = sparse.rowOffsets[i + 1];
+        ret.addRow(RowHeader(), reinterpret_cast<int const*>(sparse.columnIndices + first), static_cast<int>(last - first));
+    }
+    return ret;
+}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <DLX.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace DLX
+{
+    /*! Read-only view of an exact cover matrix in compressed sparse row format.
+     * The column indices of row i are columnIndices[rowOffsets[i]] to columnIndices[rowOffsets[i+1]-1],
+     * in ascending order.
+     */
+    struct SparseMatrix
+    {
+        int nColumns;
+        int nRows;
+        std::uint32_t const* rowOffsets;
+        std::uint32_t const* columnIndices;
+
+        SparseMatrix()
+            :nColumns(0), nRows(0), rowOffsets(nullptr), columnIndices(nullptr)
+        {}
+    };
+
+    /*! Read-only memory mapping of a whole file.
+     * Falls back to reading the file into memory on platforms without mmap.
+     */
+    class MappedFile
+    {
+        MappedFile(MappedFile const&)=delete;
+        MappedFile& operator=(MappedFile const&)=delete;
+    public:
+        MappedFile();
+
+        ~MappedFile();
+
+        bool open(std::string const& filename);
+
+        char const* data() const
+        {
+            return m_data;
+        }
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+    private:
+        char const* m_data;
+        std::size_t m_size;
+        bool m_isMapped;
+        std::vector<char> m_buffer;
+    };
+
+    /*! An exact cover matrix loaded from a file.
+     * Two formats are supported:
+     *  - text: one row per line, each line a string of '0' and '1' of the same length;
+     *  - binary: the compiled format written by writeBinaryMatrix(), which is used in place
+     *    from the memory mapping without copying.
+     * The format is detected from the file contents.
+     */
+    class MatrixFile
+    {
+        MatrixFile(MatrixFile const&)=delete;
+        MatrixFile& operator=(MatrixFile const&)=delete;
+    public:
+        MatrixFile();
+
+        /*! Load a matrix file.
+         * On failure returns false and sets error to a description of the problem.
+         */
+        bool load(std::string const& filename, std::string& error);
+
+        SparseMatrix const& getMatrix() const
+        {
+            return m_matrix;
+        }
+
+        bool isBinary() const
+        {
+            return m_isBinary;
+        }
+
+    private:
+        bool parseText(std::string& error);
+
+        bool parseBinary(std::string& error);
+
+    private:
+        MappedFile m_file;
+        std::vector<std::uint32_t> m_rowOffsets;
+        std::vector<std::uint32_t> m_columnIndices;
+        SparseMatrix m_matrix;
+        bool m_isBinary;
+    };
+
+    /*! Write a matrix in the compiled binary format.
+     * The format is a 24 byte header (the magic "DLXCSR01", the number of columns and rows as
+     * 32-bit integers and the number of non-zero entries as a 64-bit integer), followed by the
+     * row offsets and the column indices as 32-bit integers, all in native byte order.
+     */
+    bool writeBinaryMatrix(SparseMatrix const& sparse, std::string const& filename);
+
+    /*! Build the dancing links structure for a sparse matrix in a single allocation.
+     * The row headers carry no user data. See Storage for use_huge_pages.
+     */
+    Matrix createMatrix(SparseMatrix const& sparse, bool use_huge_pages = false);
+}
@@ -0,0 +1,34 @@
+#include <pentomino.hpp>
+
+#include <ostream>
+
+namespace Pentomino
+{
+namespace Free
+{
+
+std::ostream& operator<<(std::ostream& os, Shape const& s)
+{
+    using Pentomino::Free::Shape;
+    switch(s)
+    {
+        case Shape::F: return os << "F";
+        case Shape::I: return os << "I";
+        case Shape::L: return os << "L";
+        case Shape::N: return os << "N";
+        case Shape::P: return os << "P";
+        case Shape::T: return os << "T";
+        case Shape::U: return os << "U";
+        case Shape::V: return os << "V";
+        case Shape::W: return os << "W";
+        case Shape::X: return os << "X";
+        case Shape::Y: return os << "Y";
+        case Shape::Z: return os << "Z";
+        default: return os << "<Invalid Shape>";
+    }
+}
+
+static_assert(Polyomino::countOrientations(placementTable) == 63, "There are 63 fixed pentominoes");
+
+}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <polyomino.hpp>
+
+#include <array>
+#include <iosfwd>
+
+namespace Pentomino
+{
+    namespace Free
+    {
+        enum class Shape
+        {
+            F = 0,
+            I,
+            L,
+            N,
+            P,
+            T,
+            U,
+            V,
+            W,
+            X,
+            Y,
+            Z,
+            END
+        };
+
+        std::ostream& operator<<(std::ostream& os, Shape const& s);
+    }
+}
+
+namespace Polyomino
+{
+template<>
+struct Degree<Pentomino::Free::Shape>
+{
+    enum Value_T { value = 5 };
+};
+}
+
+namespace Pentomino
+{
+    namespace Free
+    {
+        using Placement = Polyomino::GenericPlacement<Shape>;
+
+        inline Shape begin()
+        {
+            return Shape::F;
+        }
+
+        inline Shape end()
+        {
+            return Shape::END;
+        }
+
+        inline Shape inc(Shape s)
+        {
+            return (s == Shape::END) ? Shape::END : static_cast<Shape>(static_cast<int>(s) + 1);
+        }
+
+        inline constexpr std::array<Polyomino::OrientationSet<Shape>, static_cast<int>(Shape::END)> placementTable = {
+            Polyomino::generateOrientations<Shape>(".##/##./.#.", Polyomino::Symmetry::Free),  // F
+            Polyomino::generateOrientations<Shape>("#####", Polyomino::Symmetry::Free),        // I
+            Polyomino::generateOrientations<Shape>("#./#./#./##", Polyomino::Symmetry::Free),  // L
+            Polyomino::generateOrientations<Shape>(".#/.#/##/#.", Polyomino::Symmetry::Free),  // N
+            Polyomino::generateOrientations<Shape>("##/##/#.", Polyomino::Symmetry::Free),     // P
+            Polyomino::generateOrientations<Shape>("###/.#./.#.", Polyomino::Symmetry::Free),  // T
+            Polyomino::generateOrientations<Shape>("#.#/###", Polyomino::Symmetry::Free),      // U
+            Polyomino::generateOrientations<Shape>("#../#../###", Polyomino::Symmetry::Free),  // V
+            Polyomino::generateOrientations<Shape>("#../##./.##", Polyomino::Symmetry::Free),  // W
+            Polyomino::generateOrientations<Shape>(".#./###/.#.", Polyomino::Symmetry::Free),  // X
+            Polyomino::generateOrientations<Shape>(".#/##/.#/.#", Polyomino::Symmetry::Free),  // Y
+            Polyomino::generateOrientations<Shape>("##./.#./.##", Polyomino::Symmetry::Free)   // Z
+        };
+
+        constexpr int getRotations(Shape const& s)
+        {
+            return placementTable[static_cast<int>(s)].count;
+        }
+
+        constexpr Placement const& getPlacement(Shape s, int rotation)
+        {
+            auto const& orientations = placementTable[static_cast<int>(s)];
+            if(rotation < 0 || rotation >= orientations.count) { PROTOCOL_VIOLATION("Invalid rotation"); }
+            return orientations.orientations[rotation];
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#include <perf_counters.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+
+#ifdef __linux__
+#   define DLX_HAS_PERF_EVENTS 1
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+namespace DLX
+{
+namespace
+{
+#ifdef DLX_HAS_PERF_EVENTS
+struct EventConfig
+{
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+EventConfig const EventConfigs[PerfCounters::EventCount] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+int openEvent(EventConfig const& event)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // calling thread only, on any cpu
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+}
+
+PerfCounters::PerfCounters()
+{
+    m_fds.fill(-1);
+#ifdef DLX_HAS_PERF_EVENTS
+    for(int i=0; i<EventCount; ++i)
+    {
+        m_fds[i] = openEvent(EventConfigs[i]);
+        if(m_fds[i] < 0 && m_error.empty()) {
+            m_error = std::string("perf_event_open failed for ") + getEventName(static_cast<Event>(i)) + ": " +
+                      std::strerror(errno);
+        }
+    }
+#else
+    m_error = "Performance counters are not supported on this platform";
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef DLX_HAS_PERF_EVENTS
+    for(auto const fd : m_fds)
+    {
+        if(fd >= 0) { close(fd); }
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable() const
+{
+    for(auto const fd : m_fds)
+    {
+        if(fd >= 0) { return true; }
+    }
+    return false;
+}
+
+void PerfCounters::start()
+{
+#ifdef DLX_HAS_PERF_EVENTS
+    for(auto const fd : m_fds)
+    {
+        if(fd < 0) { continue; }
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+PerfCounters::Values PerfCounters::stop()
+{
+    Values ret;
+#ifdef DLX_HAS_PERF_EVENTS
+    for(auto const fd : m_fds)
+    {
+        if(fd >= 0) { ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+    }
+    for(int i=0; i<EventCount; ++i)
+    {
+        if(m_fds[i] < 0) { continue; }
+        // value, time enabled, time running
+        std::uint64_t data[3];
+        if(read(m_fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) { continue; }
+        ret.available[i] = true;
+        ret.values[i] = (data[1] == data[2]) ? data[0] :
+            static_cast<std::uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+    }
+#endif
+    return ret;
+}
+
+char const* PerfCounters::getEventName(Event e)
+{
+    switch(e)
+    {
+    case Cycles:               return "cycles";
+    case Instructions:         return "instructions";
+    case L1DataMisses:         return "L1d misses";
+    case LastLevelCacheMisses: return "LLC misses";
+    case BranchMisses:         return "branch misses";
+    case EventCount:           break;
+    }
+    return "unknown";
+}
+
+void printPerfCounters(std::ostream& os, char const* phase, PerfCounters::Values const& values)
+{
+    os << phase << ":";
+    char const* separator = " ";
+    for(int i=0; i<PerfCounters::EventCount; ++i)
+    {
+        os << separator << PerfCounters::getEventName(static_cast<PerfCounters::Event>(i)) << ' ';
+        if(values.available[i]) {
+            os << values.values[i];
+        } else {
+            os << "n/a";
+        }
+        separator = ", ";
+    }
+    if(values.available[PerfCounters::Cycles] && values.available[PerfCounters::Instructions] &&
+       values.values[PerfCounters::Cycles] != 0)
+    {
+        os << ", IPC " << static_cast<double>(values.values[PerfCounters::Instructions]) /
+                          values.values[PerfCounters::Cycles];
+    }
+    os << '\n';
+}
+}
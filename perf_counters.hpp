@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace DLX
+{
+    /*! Hardware performance counters for the calling thread, read through Linux perf_event_open.
+     * Each event is opened on its own, so that a machine lacking some of them still reports the others.
+     * On other platforms, or when the kernel denies access (see /proc/sys/kernel/perf_event_paranoid),
+     * no event is available and all measurements are reported as unavailable.
+     */
+    class PerfCounters
+    {
+        PerfCounters(PerfCounters const&)=delete;
+        PerfCounters& operator=(PerfCounters const&)=delete;
+    public:
+        enum Event
+        {
+            Cycles,
+            Instructions,
+            L1DataMisses,
+            LastLevelCacheMisses,
+            BranchMisses,
+            EventCount
+        };
+
+        struct Values
+        {
+            std::array<bool, EventCount> available;
+            std::array<std::uint64_t, EventCount> values;  ///< scaled up if the kernel had to multiplex events
+
+            Values()
+                :available{}, values{}
+            {}
+        };
+
+    public:
+        PerfCounters();
+
+        ~PerfCounters();
+
+        bool isAvailable() const;
+
+        /*! Description of why events are unavailable, empty if all events could be opened.
+         */
+        std::string const& getError() const
+        {
+            return m_error;
+        }
+
+        /*! Reset and start all available counters.
+         */
+        void start();
+
+        /*! Stop all counters and return their values since the last start().
+         */
+        Values stop();
+
+        static char const* getEventName(Event e);
+
+    private:
+        std::array<int, EventCount> m_fds;
+        std::string m_error;
+    };
+
+    /*! Print the values of a phase as a single line of the form "<phase>: cycles 123, instructions 456, ...",
+     * with derived instructions per cycle if both are available.
+     */
+    void printPerfCounters(std::ostream& os, char const* phase, PerfCounters::Values const& values);
+}
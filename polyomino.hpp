@@ -1,5 +1,8 @@
 #pragma once
 
+#include <exceptions.hpp>
+
+#include <algorithm>
 #include <array>
 
 namespace Polyomino
@@ -22,4 +25,120 @@ struct GenericPlacement
     std::array<SinglePieceLayout, Degree<Shape_T>::value> layout;
 };
 
+/*! Which transformations of a base shape count as the same piece.
+ * One-sided pieces may only be rotated, free pieces may also be reflected.
+ */
+enum class Symmetry
+{
+    OneSided,
+    Free
+};
+
+/*! All distinct orientations of a single piece.
+ * A polyomino has at most 8 orientations (4 rotations, each optionally reflected).
+ */
+template<typename Shape_T>
+struct OrientationSet
+{
+    int count;
+    std::array<GenericPlacement<Shape_T>, 8> orientations;
+};
+
+namespace detail
+{
+template<typename Shape_T>
+constexpr GenericPlacement<Shape_T> normalizePlacement(GenericPlacement<Shape_T> p)
+{
+    using Layout = typename GenericPlacement<Shape_T>::SinglePieceLayout;
+    int min_x = p.layout[0].x;
+    int min_y = p.layout[0].y;
+    for(auto const& c : p.layout) { min_x = std::min(min_x, c.x); min_y = std::min(min_y, c.y); }
+    p.bound = { 0, 0 };
+    for(auto& c : p.layout)
+    {
+        c.x -= min_x;
+        c.y -= min_y;
+        p.bound.x = std::max(p.bound.x, c.x + 1);
+        p.bound.y = std::max(p.bound.y, c.y + 1);
+    }
+    // row-major order gives every orientation a unique representation
+    std::sort(begin(p.layout), end(p.layout),
+              [](Layout const& lhs, Layout const& rhs) { return (lhs.y != rhs.y) ? (lhs.y < rhs.y) : (lhs.x < rhs.x); });
+    return p;
+}
+
+template<typename Shape_T>
+constexpr bool isSamePlacement(GenericPlacement<Shape_T> const& lhs, GenericPlacement<Shape_T> const& rhs)
+{
+    for(std::size_t i=0; i<lhs.layout.size(); ++i)
+    {
+        if(lhs.layout[i].x != rhs.layout[i].x || lhs.layout[i].y != rhs.layout[i].y) { return false; }
+    }
+    return true;
+}
+}
+
+/*! Derive all distinct orientations of a piece from a bitmap of its base shape.
+ * The bitmap lists the rows of the shape from top to bottom, separated by '/', with '#' marking an occupied
+ * cell and '.' an empty one, e.g. ".#./###" for the T tetromino.
+ * Orientation 0 is the base shape, followed by its clockwise rotations and, for free pieces, the rotations
+ * of its mirror image. Duplicates due to symmetries of the shape are omitted.
+ * Intended for constant evaluation: a malformed bitmap fails to compile.
+ */
+template<typename Shape_T>
+constexpr OrientationSet<Shape_T> generateOrientations(char const* bitmap, Symmetry symmetry)
+{
+    GenericPlacement<Shape_T> base{};
+    std::size_t n_cells = 0;
+    int x = 0;
+    int y = 0;
+    for(char const* it = bitmap; *it != '\0'; ++it)
+    {
+        if(*it == '/') {
+            ++y;
+            x = 0;
+            continue;
+        } else if(*it == '#') {
+            if(n_cells == base.layout.size()) { PROTOCOL_VIOLATION("Too many cells in shape bitmap"); }
+            base.layout[n_cells++] = { x, y };
+        } else if(*it != '.') {
+            PROTOCOL_VIOLATION("Invalid character in shape bitmap");
+        }
+        ++x;
+    }
+    if(n_cells != base.layout.size()) { PROTOCOL_VIOLATION("Too few cells in shape bitmap"); }
+
+    OrientationSet<Shape_T> ret{};
+    auto candidate = base;
+    int const n_reflections = (symmetry == Symmetry::Free) ? 2 : 1;
+    for(int reflection = 0; reflection < n_reflections; ++reflection)
+    {
+        for(int rotation = 0; rotation < 4; ++rotation)
+        {
+            auto const normalized = detail::normalizePlacement(candidate);
+            bool is_new = true;
+            for(int i=0; i<ret.count; ++i)
+            {
+                if(detail::isSamePlacement(ret.orientations[i], normalized)) { is_new = false; }
+            }
+            if(is_new) { ret.orientations[ret.count++] = normalized; }
+            // rotate clockwise
+            for(auto& c : candidate.layout) { c = { -c.y, c.x }; }
+        }
+        // mirror along the vertical axis
+        for(auto& c : candidate.layout) { c.x = -c.x; }
+    }
+    return ret;
+}
+
+/*! Total number of orientations over all shapes of a piece family.
+ */
+template<typename Shape_T, std::size_t N>
+constexpr int countOrientations(std::array<OrientationSet<Shape_T>, N> const& table)
+{
+    int ret = 0;
+    for(auto const& o : table) { ret += o.count; }
+    return ret;
+}
+
 }
@@ -0,0 +1,111 @@
+#include <problem_file.hpp>
+
+#include <istream>
+#include <ostream>
+
+namespace Tetromino
+{
+namespace OneSided
+{
+
+bool shapeFromChar(char c, Shape& s)
+{
+    switch(c)
+    {
+    case 'i': case 'I': s = Shape::I; return true;
+    case 'o': case 'O': s = Shape::O; return true;
+    case 't': case 'T': s = Shape::T; return true;
+    case 'j': case 'J': s = Shape::J; return true;
+    case 'l': case 'L': s = Shape::L; return true;
+    case 's': case 'S': s = Shape::S; return true;
+    case 'z': case 'Z': s = Shape::Z; return true;
+    default: return false;
+    }
+}
+
+bool parsePieces(std::string const& str, std::vector<Shape>& pieces, char& error_char)
+{
+    pieces.clear();
+    pieces.reserve(str.length());
+    for(char c : str)
+    {
+        Shape s;
+        if(!shapeFromChar(c, s)) { error_char = c; return false; }
+        pieces.push_back(s);
+    }
+    return true;
+}
+
+bool readProblemDescription(std::istream& is, ProblemDescription& problem)
+{
+    std::string pieces;
+    if(!(is >> problem.fieldSize.x >> problem.fieldSize.y >> pieces)) { return false; }
+    if(problem.fieldSize.x <= 0 || problem.fieldSize.y <= 0) { return false; }
+    char error_char;
+    if(!parsePieces(pieces, problem.pieces, error_char)) { return false; }
+
+    problem.board = Polyomino::BoardMask(problem.fieldSize);
+    problem.fixedPlacements.clear();
+    std::string token;
+    if(!(is >> token)) { return is.eof(); }
+    if(token != "fixed") {
+        for(int y = 0; ; )
+        {
+            if(static_cast<int>(token.length()) != problem.fieldSize.x) { return false; }
+            for(int x = 0; x < problem.fieldSize.x; ++x)
+            {
+                if(token[x] == '#') {
+                    problem.board.blockCell(x, y);
+                } else if(token[x] != '.') {
+                    return false;
+                }
+            }
+            if(++y == problem.fieldSize.y) { break; }
+            if(!(is >> token)) { return false; }
+        }
+        if(!(is >> token)) { return is.eof(); }
+    }
+    do {
+        if(token != "fixed") { return false; }
+        Polyomino::FixedPlacement<Shape> fixed;
+        if(!(is >> token) || token.length() != 1 || !shapeFromChar(token[0], fixed.shape)) { return false; }
+        if(!(is >> fixed.rotation >> fixed.x >> fixed.y)) { return false; }
+        problem.fixedPlacements.push_back(fixed);
+    } while(is >> token);
+    return is.eof();
+}
+
+void writeProblemDescription(std::ostream& os, ProblemDescription const& problem)
+{
+    os << problem.fieldSize.x << '\n' << problem.fieldSize.y << '\n';
+    for(auto const& s : problem.pieces) { os << s; }
+    os << '\n';
+    if(problem.board.getOpenCellCount() != problem.fieldSize.x * problem.fieldSize.y) {
+        for(int y = 0; y < problem.fieldSize.y; ++y)
+        {
+            for(int x = 0; x < problem.fieldSize.x; ++x) { os << (problem.board.isOpen(x, y) ? '.' : '#'); }
+            os << '\n';
+        }
+    }
+    for(auto const& f : problem.fixedPlacements)
+    {
+        os << "fixed " << f.shape << ' ' << f.rotation << ' ' << f.x << ' ' << f.y << '\n';
+    }
+}
+
+bool addPieces(Polyomino::ProblemInstance<Shape>& problem, ProblemDescription const& description)
+{
+    for(auto const& s : description.pieces)
+    {
+        problem.addPiece(s);
+    }
+    for(auto const& f : description.fixedPlacements)
+    {
+        if(!problem.canFixPlacement(f)) { return false; }
+        problem.addFixedPlacement(f);
+    }
+    return true;
+}
+
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Tetromino
+{
+    namespace OneSided
+    {
+        /*! Plain description of a problem as it is stored in the files under problems/.
+         * The file format is the field width, the field height and a string of piece letters,
+         * separated by whitespace. For irregular boards these may be followed by one line per row
+         * of the field, with '.' marking an open cell and '#' a blocked cell.
+         * Pieces can be fixed at a position by appending entries "fixed <piece> <rotation> <x> <y>", each of
+         * which takes one piece of that shape from the inventory. <x> <y> is the top left corner of the bounding
+         * box of the piece. <rotation> is the index of the orientation in the placement table: orientation 0 is
+         * the base shape from tetromino.hpp, followed by its distinct clockwise rotations (see
+         * Polyomino::generateOrientations()). Rows of the bounding box from top to bottom, '#' marking a cell:
+         *   I: 0 ####          1 #/#/#/#
+         *   O: 0 ##/##
+         *   T: 0 .#./###       1 #./##/#.      2 ###/.#.       3 .#/##/.#
+         *   J: 0 .#/.#/##      1 #../###       2 ##/#./#.      3 ###/..#
+         *   L: 0 #./#./##      1 ###/#..       2 ##/.#/.#      3 ..#/###
+         *   S: 0 .##/##.       1 #./##/.#
+         *   Z: 0 ##./.##       1 .#/##/#.
+         * Problem files depend on this numbering, so it must not change.
+         */
+        struct ProblemDescription
+        {
+            Polyomino::FieldSize fieldSize;
+            std::vector<Shape> pieces;
+            Polyomino::BoardMask board;
+            std::vector<Polyomino::FixedPlacement<Shape>> fixedPlacements;
+        };
+
+        /*! Convert a piece letter (case-insensitive) to its Shape.
+         * Returns false if the character does not denote a one-sided tetromino.
+         */
+        bool shapeFromChar(char c, Shape& s);
+
+        /*! Parse a string of piece letters.
+         * On failure returns false and stores the offending character in error_char.
+         */
+        bool parsePieces(std::string const& str, std::vector<Shape>& pieces, char& error_char);
+
+        /*! Read a problem from a stream in the problems/ file format.
+         * Returns false if the stream does not contain a well-formed problem.
+         */
+        bool readProblemDescription(std::istream& is, ProblemDescription& problem);
+
+        /*! Write a problem in the problems/ file format, so that readProblemDescription() reads it back.
+         * The rows of the field are only written if some cell is blocked.
+         */
+        void writeProblemDescription(std::ostream& os, ProblemDescription const& problem);
+
+        /*! Populate a ProblemInstance with the pieces and fixed placements from a description.
+         * Returns false if a fixed placement is invalid for the problem, see ProblemInstance::canFixPlacement().
+         */
+        bool addPieces(Polyomino::ProblemInstance<Shape>& problem, ProblemDescription const& description);
+    }
+}
@@ -4,6 +4,8 @@
 #include <exceptions.hpp>
 #include <polyomino.hpp>
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 namespace Polyomino
@@ -15,6 +17,81 @@ struct FieldSize
     int y;
 };
 
+/*! The cells of a rectangular field that are open for placing pieces.
+ * Blocked cells are not covered by any piece and get no column in the problem matrix, which allows
+ * non-rectangular boards and boards with holes.
+ */
+class BoardMask
+{
+public:
+    BoardMask()
+        :m_fieldSize{0, 0}, m_openCellCount(0)
+    {}
+
+    explicit BoardMask(FieldSize const& field_size)
+        :m_fieldSize(field_size), m_cellIndices(field_size.x * field_size.y), m_openCellCount(field_size.x * field_size.y)
+    {
+        for(int i=0; i<m_openCellCount; ++i) { m_cellIndices[i] = i; }
+    }
+
+    FieldSize getFieldSize() const
+    {
+        return m_fieldSize;
+    }
+
+    bool isOpen(int x, int y) const
+    {
+        return m_cellIndices[y * m_fieldSize.x + x] != -1;
+    }
+
+    void blockCell(int x, int y)
+    {
+        if(x < 0 || x >= m_fieldSize.x || y < 0 || y >= m_fieldSize.y) { PROTOCOL_VIOLATION("Invalid cell"); }
+        if(!isOpen(x, y)) { return; }
+        // open cells are numbered consecutively in row-major order
+        int i = y * m_fieldSize.x + x;
+        m_cellIndices[i++] = -1;
+        for(; i<static_cast<int>(m_cellIndices.size()); ++i)
+        {
+            if(m_cellIndices[i] != -1) { --m_cellIndices[i]; }
+        }
+        --m_openCellCount;
+    }
+
+    /*! Index of the cell among all open cells in row-major order, or -1 if the cell is blocked.
+     */
+    int getCellIndex(int x, int y) const
+    {
+        return m_cellIndices[y * m_fieldSize.x + x];
+    }
+
+    int getOpenCellCount() const
+    {
+        return m_openCellCount;
+    }
+
+    bool isRectangular() const
+    {
+        return m_openCellCount == m_fieldSize.x * m_fieldSize.y;
+    }
+
+private:
+    FieldSize m_fieldSize;
+    std::vector<int> m_cellIndices;
+    int m_openCellCount;
+};
+
+/*! A piece fixed at a position of the field, given by its orientation and the top-left corner of its bounding box.
+ */
+template<typename Shape_T>
+struct FixedPlacement
+{
+    Shape_T shape;
+    int rotation;
+    int x;
+    int y;
+};
+
 template<typename Shape_T>
 class ProblemInstance
 {
@@ -22,70 +99,183 @@ class ProblemInstance
     ProblemInstance& operator=(ProblemInstance const&)=delete;
 public:
     ProblemInstance(FieldSize const& field_size)
-        :m_fieldSize(field_size)
+        :ProblemInstance(BoardMask(field_size))
+    {}
+
+    ProblemInstance(BoardMask const& board)
+        :m_fieldSize(board.getFieldSize()), m_board(board)
     {
-        if ((m_fieldSize.x * m_fieldSize.y) % Degree<Shape_T>::value != 0) {
+        if (m_board.getOpenCellCount() % Degree<Shape_T>::value != 0) {
             PROTOCOL_VIOLATION("Invalid field size");
         }
     }
 
+    /*! Add a piece to the inventory.
+     * The inventory may exceed the number of pieces required to fill the field, in which case
+     * the problem is to fill the field with any subset of the pieces.
+     */
     void addPiece(Shape_T const& s)
     {
-        if((m_pieces.size() + 1) > getRequiredPieceCount()) { PROTOCOL_VIOLATION("Too many pieces"); }
         m_pieces.push_back(s);
     }
 
+    /*! Check whether a piece of the inventory can be fixed at a position.
+     * This requires a piece of the shape that is not fixed yet, a valid rotation, and a position inside the
+     * field on open cells that are not covered by another fixed placement.
+     */
+    bool canFixPlacement(FixedPlacement<Shape_T> const& fixed) const
+    {
+        if(findUnfixedPiece(fixed.shape) == -1) { return false; }
+        if(fixed.rotation < 0 || fixed.rotation >= getRotations(fixed.shape)) { return false; }
+        auto const placement = getPlacement(fixed.shape, fixed.rotation);
+        if(fixed.x < 0 || fixed.y < 0 || fixed.x + placement.bound.x > m_fieldSize.x ||
+           fixed.y + placement.bound.y > m_fieldSize.y)
+        {
+            return false;
+        }
+        if(!isPlacementOnOpenCells(placement, fixed.x, fixed.y)) { return false; }
+        for(auto const& other : m_fixedPlacements)
+        {
+            auto const other_placement = getPlacement(m_pieces[other.piece], other.rotation);
+            for(auto const& p : placement.layout)
+            {
+                for(auto const& q : other_placement.layout)
+                {
+                    if(fixed.x + p.x == other.x + q.x && fixed.y + p.y == other.y + q.y) { return false; }
+                }
+            }
+        }
+        return true;
+    }
+
+    /*! Fix a piece of the inventory at a position, see canFixPlacement().
+     * The problem matrix starts out with the row of the placement selected, so only the rest of the field
+     * is searched and the fixed pieces are reported as part of every solution.
+     */
+    void addFixedPlacement(FixedPlacement<Shape_T> const& fixed)
+    {
+        if(!canFixPlacement(fixed)) { PROTOCOL_VIOLATION("Invalid fixed placement"); }
+        m_fixedPlacements.push_back(FixedPiece{ findUnfixedPiece(fixed.shape), fixed.rotation, fixed.x, fixed.y });
+    }
+
     int getRequiredPieceCount() const
     {
-        auto const field_area = m_fieldSize.x * m_fieldSize.y;
+        auto const field_area = m_board.getOpenCellCount();
         return field_area / Degree<Shape_T>::value;
     }
 
-    DLX::Matrix calculateProblemMatrix() const
+    /*! Number of piece columns of the problem matrix, which precede the cell columns.
+     * This is one column per piece, or one column per distinct shape if there are surplus pieces.
+     */
+    int getPieceColumnCount() const
+    {
+        return static_cast<int>(getPieceColumns().size());
+    }
+
+    /*! Column of the problem matrix for a cell of the field, or -1 if the cell is blocked.
+     * Columns i < getPieceColumnCount() are the piece columns, so DLX::SearchState::getRemaining(i) tells how many
+     * of their pieces are still to be placed and DLX::SearchState::isOccupied() on the cell columns gives the board.
+     */
+    int getCellColumn(int x, int y) const
     {
-        if(m_pieces.size() != getRequiredPieceCount()) { PROTOCOL_VIOLATION("Not enough pieces to solve"); }
-        int const field_area = m_fieldSize.x * m_fieldSize.y;
-        int nColumns =  static_cast<int>(m_pieces.size()) + field_area;
-        DLX::Matrix m(nColumns);
+        int const cell_index = m_board.getCellIndex(x, y);
+        return (cell_index == -1) ? -1 : getPieceColumnCount() + cell_index;
+    }
+
+    /*! Exact number of rows of the problem matrix, that is the number of all possible placements
+     * of the pieces of all piece columns on the open cells of the field.
+     */
+    int getPlacementCount() const
+    {
+        int ret = 0;
+        for(auto const& piece_column : getPieceColumns())
+        {
+            auto const piece = m_pieces[piece_column.piece];
+            for(int rot=0; rot<getRotations(piece); ++rot)
+            {
+                auto const placement = getPlacement(piece, rot);
+                for(int x = 0; x < (m_fieldSize.x - placement.bound.x + 1); ++x)
+                {
+                    for(int y = 0; y < (m_fieldSize.y - placement.bound.y + 1); ++y)
+                    {
+                        if(isPlacementOnOpenCells(placement, x, y)) { ++ret; }
+                    }
+                }
+            }
+        }
+        return ret;
+    }
+
+    /*! Build the problem matrix in a single allocation. See DLX::Storage for use_huge_pages.
+     */
+    DLX::Matrix calculateProblemMatrix(bool use_huge_pages = false) const
+    {
+        if(static_cast<int>(m_pieces.size()) < getRequiredPieceCount()) { PROTOCOL_VIOLATION("Not enough pieces to solve"); }
+        int const field_area = m_board.getOpenCellCount();
+        auto const piece_columns = getPieceColumns();
+        int const nPieces = static_cast<int>(piece_columns.size());
+        int nColumns =  nPieces + field_area;
+        int const nRows = getPlacementCount();
+        DLX::Matrix m(nColumns, nRows, static_cast<std::size_t>(nRows) * (Degree<Shape_T>::value + 1), use_huge_pages);
         int pieceCount = 0;
-        std::vector<int> occupied_fields;
-        for(auto const& piece : m_pieces)
+        int rowIndex = 0;
+        std::vector<int> fixed_rows(m_fixedPlacements.size(), -1);
+        // piece column of each fixed placement, which is the column of the piece unless pieces are grouped by shape
+        std::vector<int> fixed_columns;
+        for(auto const& f : m_fixedPlacements)
+        {
+            if(!hasSurplusPieces()) {
+                fixed_columns.push_back(f.piece);
+                continue;
+            }
+            auto const it = std::find_if(begin(piece_columns), end(piece_columns),
+                                         [&](PieceColumn const& c) { return m_pieces[c.piece] == m_pieces[f.piece]; });
+            fixed_columns.push_back(static_cast<int>(it - begin(piece_columns)));
+        }
+        // one column for the piece, followed by one column for each cell covered by the piece
+        std::array<int, Degree<Shape_T>::value + 1> occupied_fields;
+        for(auto const& piece_column : piece_columns)
         {
+            auto const piece = m_pieces[piece_column.piece];
             for(int rot=0; rot<getRotations(piece); ++rot)
             {
                 auto const placement = getPlacement(piece, rot);
+                // cells of the placement in ascending row-major order, which is also the order of their columns
+                auto layout = placement.layout;
+                std::sort(begin(layout), end(layout),
+                          [](auto const& lhs, auto const& rhs) { return (lhs.y != rhs.y) ? (lhs.y < rhs.y) : (lhs.x < rhs.x); });
                 for(int x = 0; x < (m_fieldSize.x - placement.bound.x + 1); ++x)
                 {
                     for(int y = 0; y < (m_fieldSize.y - placement.bound.y + 1); ++y)
                     {
-                        occupied_fields.clear();
+                        if(!isPlacementOnOpenCells(placement, x, y)) { continue; }
                         DLX::RowHeader row_header;
-                        row_header.UserData = &m_pieces[pieceCount];
+                        row_header.UserData = &m_pieces[piece_column.piece];
 
-                        // traverse piece columns
-                        int i = 0;
-                        for(; i<static_cast<int>(m_pieces.size()); ++i)
+                        occupied_fields[0] = pieceCount;
+                        for(std::size_t i=0; i<layout.size(); ++i)
                         {
-                            if (i == pieceCount) { occupied_fields.push_back(i); }
+                            occupied_fields[i + 1] = nPieces + m_board.getCellIndex(x + layout[i].x, y + layout[i].y);
                         }
-                        // traverse field columns
-                        for(int iy = 0; iy < m_fieldSize.y; ++iy)
+                        m.addRow(row_header, occupied_fields.data(), static_cast<int>(occupied_fields.size()));
+                        for(std::size_t i=0; i<m_fixedPlacements.size(); ++i)
                         {
-                            for(int ix = 0; ix < m_fieldSize.x; ++ix)
-                            {
-                                for(auto const& p : placement.layout)
-                                {
-                                    if(x + p.x == ix && y + p.y == iy) { occupied_fields.push_back(i); break; }
-                                }
-                                ++i;
-                            }
+                            auto const& f = m_fixedPlacements[i];
+                            if(fixed_columns[i] == pieceCount && f.rotation == rot && f.x == x && f.y == y) { fixed_rows[i] = rowIndex; }
                         }
-                        m.addRow(row_header, occupied_fields);
+                        ++rowIndex;
                     }
                 }
             }
             ++pieceCount;
         }
+        // rows were added piece by piece, lay them out by board position instead
+        m.optimizeLayout(nPieces);
+        if(hasSurplusPieces()) {
+            // every solution covers all cells, so it automatically uses exactly the required number of pieces
+            for(int i=0; i<nPieces; ++i) { m.setColumnMultiplicity(i, piece_columns[i].count); }
+        }
+        for(auto const row : fixed_rows) { m.selectRow(row); }
         return m;
     }
 
@@ -94,15 +284,103 @@ public:
         return m_fieldSize;
     }
 
+    BoardMask const& getBoard() const
+    {
+        return m_board;
+    }
+
     int getCurrentPieceCount() const
     {
         return static_cast<int>(m_pieces.size());
     }
 
+    std::vector<Shape_T> const& getPieces() const
+    {
+        return m_pieces;
+    }
+
+    std::vector<FixedPlacement<Shape_T>> getFixedPlacements() const
+    {
+        std::vector<FixedPlacement<Shape_T>> ret;
+        for(auto const& f : m_fixedPlacements) { ret.push_back(FixedPlacement<Shape_T>{ m_pieces[f.piece], f.rotation, f.x, f.y }); }
+        return ret;
+    }
+
+    /*! Whether the inventory contains more pieces than needed to fill the field.
+     * The problem matrix then has one secondary column per distinct shape, whose multiplicity is the number of
+     * pieces of that shape, so each tiling is found once no matter which of the identical pieces it uses.
+     */
+    bool hasSurplusPieces() const
+    {
+        return static_cast<int>(m_pieces.size()) > getRequiredPieceCount();
+    }
+
+
+private:
+    struct FixedPiece
+    {
+        int piece;          ///< index into m_pieces
+        int rotation;
+        int x;
+        int y;
+    };
+
+    /* A piece column of the problem matrix, given by the first piece it stands for and the number of pieces.
+     */
+    struct PieceColumn
+    {
+        int piece;
+        int count;
+    };
+
+    /* One column per piece for exact inventories, so that every piece is placed exactly once. Surplus pieces
+     * would make the search enumerate every choice of identical pieces, so those share a column per shape.
+     */
+    std::vector<PieceColumn> getPieceColumns() const
+    {
+        std::vector<PieceColumn> ret;
+        bool const group_shapes = hasSurplusPieces();
+        for(int i=0; i<static_cast<int>(m_pieces.size()); ++i)
+        {
+            auto const it = std::find_if(begin(ret), end(ret),
+                                         [&](PieceColumn const& c) { return m_pieces[c.piece] == m_pieces[i]; });
+            if(group_shapes && it != end(ret)) {
+                ++it->count;
+            } else {
+                ret.push_back(PieceColumn{ i, 1 });
+            }
+        }
+        return ret;
+    }
+
+    /* Index of the first piece of the given shape that has not been fixed yet, or -1 if there is none.
+     */
+    int findUnfixedPiece(Shape_T shape) const
+    {
+        for(int i=0; i<static_cast<int>(m_pieces.size()); ++i)
+        {
+            if(m_pieces[i] != shape) { continue; }
+            if(std::none_of(begin(m_fixedPlacements), end(m_fixedPlacements),
+                            [i](FixedPiece const& f) { return f.piece == i; }))
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool isPlacementOnOpenCells(GenericPlacement<Shape_T> const& placement, int x, int y) const
+    {
+        if(m_board.isRectangular()) { return true; }
+        return std::all_of(begin(placement.layout), end(placement.layout),
+                           [&](auto const& p) { return m_board.isOpen(x + p.x, y + p.y); });
+    }
 
 private:
     FieldSize const m_fieldSize;
+    BoardMask const m_board;
     std::vector<Shape_T> m_pieces;
+    std::vector<FixedPiece> m_fixedPlacements;
 };
 
 }
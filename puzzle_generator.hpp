@@ -0,0 +1,237 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <exceptions.hpp>
+#include <master_matrix.hpp>
+#include <polyomino.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! Generator for puzzles that have exactly one solution up to the symmetries of the field.
+ * Candidates are rectangular fields of random size filled with a random piece multiset. Each candidate is
+ * checked on the cached MasterMatrix of its size, so identical pieces are interchangeable and a tiling is
+ * one solution regardless of which copy of a shape goes where.
+ *
+ * The uniqueness check stops at the second solution, which rejects most ambiguous candidates after finding
+ * two tilings. Only if the second tiling is a rotation or reflection of the first does the search continue,
+ * until either a tiling outside the symmetry class of the first one turns up or the search is exhausted.
+ */
+template<typename Shape_T>
+class PuzzleGenerator
+{
+public:
+    struct Puzzle
+    {
+        FieldSize fieldSize;
+        std::vector<Shape_T> pieces;        ///< sorted by shape
+    };
+
+    struct Statistics
+    {
+        std::uint64_t candidates;
+        std::uint64_t unsolvable;       ///< candidates without any solution
+        std::uint64_t ambiguous;        ///< candidates with more than one solution up to symmetry
+        std::uint64_t duplicates;       ///< unique candidates that had been generated before
+
+        Statistics()
+            :candidates(0), unsolvable(0), ambiguous(0), duplicates(0)
+        {}
+    };
+
+    /*! A tiling as the set of cells covered by each placement, which is independent of the row numbering
+     * and of which copy of a shape was used.
+     */
+    typedef std::vector<std::vector<int>> Tiling;
+
+public:
+    /*! Generate puzzles on fields with sides between min_side and max_side, with the width at most the height.
+     */
+    PuzzleGenerator(int min_side, int max_side, std::uint64_t seed)
+        :m_minSide(min_side), m_maxSide(max_side), m_seed(seed)
+    {
+        if(min_side < 1 || max_side < min_side) { PROTOCOL_VIOLATION("Invalid field size range"); }
+        bool has_area = false;
+        for(int x = min_side; x <= max_side; ++x)
+        {
+            for(int y = x; y <= max_side; ++y) { has_area = has_area || (x * y) % Degree<Shape_T>::value == 0; }
+        }
+        if(!has_area) { PROTOCOL_VIOLATION("No field size in range can be filled with pieces"); }
+    }
+
+    /*! Generate count distinct puzzles on n_threads threads.
+     * Puzzles are returned in the order in which they were found, which depends on the scheduling of the threads.
+     */
+    std::vector<Puzzle> generate(std::size_t count, int n_threads = 1)
+    {
+        if(n_threads < 1) { PROTOCOL_VIOLATION("Generator needs at least one thread"); }
+        m_statistics = Statistics();
+        std::vector<Puzzle> ret;
+        std::set<std::tuple<int, int, std::vector<Shape_T>>> seen;
+        std::mutex mutex;
+        std::atomic<bool> done(count == 0);
+        auto const worker = [&, this](int thread_index) {
+            std::mt19937_64 rng(m_seed + thread_index);
+            Statistics statistics;
+            while(!done.load(std::memory_order_relaxed))
+            {
+                auto const candidate = sampleCandidate(rng);
+                ++statistics.candidates;
+                auto const result = checkUniqueness(candidate);
+                if(result == Result::Unsolvable) { ++statistics.unsolvable; continue; }
+                if(result == Result::Ambiguous) { ++statistics.ambiguous; continue; }
+                std::lock_guard<std::mutex> lock(mutex);
+                if(done) { break; }
+                if(!seen.insert(std::make_tuple(candidate.fieldSize.x, candidate.fieldSize.y, candidate.pieces)).second) {
+                    ++statistics.duplicates;
+                    continue;
+                }
+                ret.push_back(candidate);
+                if(ret.size() == count) { done = true; }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            m_statistics.candidates += statistics.candidates;
+            m_statistics.unsolvable += statistics.unsolvable;
+            m_statistics.ambiguous += statistics.ambiguous;
+            m_statistics.duplicates += statistics.duplicates;
+        };
+        std::vector<std::thread> threads;
+        for(int i=1; i<n_threads; ++i) { threads.emplace_back(worker, i); }
+        worker(0);
+        for(auto& t : threads) { t.join(); }
+        return ret;
+    }
+
+    /*! Counters of the last call to generate(), summed over all threads.
+     */
+    Statistics const& getStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*! Check whether the pieces tile the field in exactly one way up to rotations and reflections of the field.
+     * Uses the MasterMatrix cache of the calling thread.
+     */
+    static bool hasUniqueSolution(FieldSize const& field_size, std::vector<Shape_T> const& pieces)
+    {
+        return checkUniqueness(Puzzle{ field_size, pieces }) == Result::Unique;
+    }
+
+private:
+    enum class Result
+    {
+        Unique,
+        Unsolvable,
+        Ambiguous
+    };
+
+    template<typename Rng_T>
+    Puzzle sampleCandidate(Rng_T& rng) const
+    {
+        std::uniform_int_distribution<int> side(m_minSide, m_maxSide);
+        std::uniform_int_distribution<int> shape(0, MasterMatrix<Shape_T>::ShapeCount - 1);
+        Puzzle ret;
+        do {
+            ret.fieldSize = FieldSize{ side(rng), side(rng) };
+            if(ret.fieldSize.x > ret.fieldSize.y) { std::swap(ret.fieldSize.x, ret.fieldSize.y); }
+        } while((ret.fieldSize.x * ret.fieldSize.y) % Degree<Shape_T>::value != 0);
+        int const n_pieces = ret.fieldSize.x * ret.fieldSize.y / Degree<Shape_T>::value;
+        for(int i=0; i<n_pieces; ++i) { ret.pieces.push_back(static_cast<Shape_T>(shape(rng))); }
+        std::sort(begin(ret.pieces), end(ret.pieces));
+        return ret;
+    }
+
+    static Result checkUniqueness(Puzzle const& candidate)
+    {
+        auto& master = MasterMatrix<Shape_T>::getCached(candidate.fieldSize);
+        auto solutions = master.solveUpTo(candidate.pieces, 2);
+        if(solutions.empty()) { return Result::Unsolvable; }
+        if(solutions.size() == 1) { return Result::Unique; }
+
+        auto const images = getSymmetricImages(master, solutions[0]);
+        if(!isImage(images, getTiling(master, solutions[1]))) { return Result::Ambiguous; }
+        // the images of the first tiling are distinct tilings, so finding more than that proves ambiguity
+        solutions = master.solveUpTo(candidate.pieces, images.size() + 1);
+        if(solutions.size() > images.size()) { return Result::Ambiguous; }
+        for(auto const& s : solutions)
+        {
+            if(!isImage(images, getTiling(master, s))) { return Result::Ambiguous; }
+        }
+        return Result::Unique;
+    }
+
+    static bool isImage(std::vector<Tiling> const& images, Tiling const& tiling)
+    {
+        return std::find(begin(images), end(images), tiling) != end(images);
+    }
+
+    /* Cells of a tiling in canonical form, after mapping each cell (x, y) through transform.
+     */
+    template<typename Transform_T>
+    static Tiling getTiling(MasterMatrix<Shape_T> const& master, DLX::Matrix::Solution const& solution,
+                            Transform_T const& transform)
+    {
+        auto const field_size = master.getFieldSize();
+        Tiling ret;
+        for(auto const row : solution)
+        {
+            auto const& record = master.getPlacementRecord(row);
+            std::vector<int> cells;
+            for(auto const& c : getPlacement(record.shape, record.rotation).layout)
+            {
+                auto const [x, y] = transform(record.x + c.x, record.y + c.y);
+                cells.push_back(y * field_size.x + x);
+            }
+            std::sort(begin(cells), end(cells));
+            ret.push_back(std::move(cells));
+        }
+        std::sort(begin(ret), end(ret));
+        return ret;
+    }
+
+    static Tiling getTiling(MasterMatrix<Shape_T> const& master, DLX::Matrix::Solution const& solution)
+    {
+        return getTiling(master, solution, [](int x, int y) { return std::make_pair(x, y); });
+    }
+
+    /* Distinct images of a tiling under the symmetries of the field: the rotation by 180 degrees and
+     * the two reflections, and for square fields also the rotations by 90 degrees and the diagonal reflections.
+     */
+    static std::vector<Tiling> getSymmetricImages(MasterMatrix<Shape_T> const& master,
+                                                  DLX::Matrix::Solution const& solution)
+    {
+        auto const field_size = master.getFieldSize();
+        int const n_symmetries = (field_size.x == field_size.y) ? 8 : 4;
+        std::vector<Tiling> ret;
+        for(int i=0; i<n_symmetries; ++i)
+        {
+            auto tiling = getTiling(master, solution, [field_size, i](int x, int y) {
+                if(i & 4) { std::swap(x, y); }
+                if(i & 1) { x = field_size.x - 1 - x; }
+                if(i & 2) { y = field_size.y - 1 - y; }
+                return std::make_pair(x, y);
+            });
+            if(!isImage(ret, tiling)) { ret.push_back(std::move(tiling)); }
+        }
+        return ret;
+    }
+
+private:
+    int const m_minSide;
+    int const m_maxSide;
+    std::uint64_t const m_seed;
+    Statistics m_statistics;
+};
+
+}
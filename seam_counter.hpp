@@ -0,0 +1,354 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <exceptions.hpp>
+#include <polyomino.hpp>
+#include <problem_instance.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! Counts the tilings of a rectangular field by a piece multiset by cutting the field in two along a seam.
+ * Every placement of a tiling lies on one side of the seam or crosses it. The tilings of each side are
+ * enumerated on their own, by placements that cover at least one cell of that side, so the placements
+ * crossing the seam appear in the tilings of both sides. Two tilings of the sides combine to a tiling
+ * of the field exactly if they agree on the crossing placements and their pieces add up to the multiset.
+ * Both sides are therefore tallied in a hash table under the set of crossing placements and their piece
+ * counts, and the number of tilings of the field is found by joining the two tables on that key.
+ *
+ * The work is about the sum of the two side enumerations instead of their product. It pays off on fields
+ * that are too large to search as a whole, while each half still has a manageable number of tilings.
+ * As with MasterMatrix, identical pieces are interchangeable, so each tiling is counted once.
+ */
+template<typename Shape_T>
+class SeamCounter
+{
+    SeamCounter(SeamCounter const&)=delete;
+    SeamCounter& operator=(SeamCounter const&)=delete;
+public:
+    static constexpr int ShapeCount = static_cast<int>(Shape_T::END);
+
+    /*! A horizontal seam runs between the rows position - 1 and position,
+     * a vertical seam between the columns position - 1 and position.
+     */
+    struct Seam
+    {
+        bool horizontal;
+        int position;
+    };
+
+    struct Statistics
+    {
+        std::uint64_t partialTilings[2];    ///< tilings of the side before and after the seam
+        std::uint64_t keys[2];              ///< distinct keys among the tilings of each side
+        std::uint64_t crossingPlacements;   ///< placements crossing the seam
+        DLX::SearchStatistics search;       ///< work counters of both searches, summed over all threads
+
+        Statistics()
+            :partialTilings{}, keys{}, crossingPlacements(0)
+        {}
+    };
+
+public:
+    /*! Cut the field across its longer side in the middle, which gives the shortest seam.
+     */
+    explicit SeamCounter(FieldSize const& field_size)
+        :SeamCounter(field_size, getDefaultSeam(field_size))
+    {}
+
+    SeamCounter(FieldSize const& field_size, Seam const& seam)
+        :m_fieldSize(field_size), m_seam(seam), m_crossingCount(0)
+    {
+        int const extent = seam.horizontal ? field_size.y : field_size.x;
+        if(field_size.x <= 0 || field_size.y <= 0 || seam.position <= 0 || seam.position >= extent) {
+            PROTOCOL_VIOLATION("Seam must cut the field into two non-empty sides");
+        }
+        buildSides();
+    }
+
+    static Seam getDefaultSeam(FieldSize const& field_size)
+    {
+        return (field_size.y >= field_size.x) ? Seam{ true, field_size.y / 2 } : Seam{ false, field_size.x / 2 };
+    }
+
+    /*! Number of tilings of the field by exactly the given pieces, counted on n_threads threads.
+     */
+    std::uint64_t count(std::vector<Shape_T> const& pieces, int n_threads = 1)
+    {
+        if(n_threads < 1) { PROTOCOL_VIOLATION("Seam counter needs at least one thread"); }
+        if(static_cast<int>(pieces.size()) * Degree<Shape_T>::value != m_fieldSize.x * m_fieldSize.y) {
+            PROTOCOL_VIOLATION("Piece area does not match field size");
+        }
+        ShapeCounts shape_counts{};
+        for(auto const& s : pieces) { ++shape_counts[static_cast<int>(s)]; }
+        m_statistics = Statistics();
+        m_statistics.crossingPlacements = m_crossingCount;
+
+        // the searches of both sides are split into one sub-search per placement on the first cell of the side
+        std::vector<std::pair<int, int>> work_items;
+        for(int side=0; side<2; ++side)
+        {
+            for(auto const row : m_sides[side].firstCellRows)
+            {
+                if(shape_counts[m_sides[side].rows[row].shape] > 0) { work_items.emplace_back(side, row); }
+            }
+        }
+        std::atomic<std::size_t> next_item(0);
+        std::vector<std::array<Table, 2>> tables(n_threads);
+        std::vector<DLX::SearchStatistics> statistics(n_threads);
+        auto const worker = [&, this](int thread_index) {
+            std::array<DLX::Matrix, 2> matrices = { m_sides[0].matrix.clone(), m_sides[1].matrix.clone() };
+            for(auto& m : matrices) { applyShapeCounts(m, shape_counts); }
+            Key key;
+            for(std::size_t i = next_item++; i < work_items.size(); i = next_item++)
+            {
+                auto const [side, row] = work_items[i];
+                auto& table = tables[thread_index][side];
+                auto const& rows = m_sides[side].rows;
+                matrices[side].selectRow(row);
+                matrices[side].solveAll([&](DLX::Matrix::Solution const& solution) {
+                    makeKey(side, rows, solution, shape_counts, key);
+                    ++table[key];
+                    return true;
+                });
+                matrices[side].unselectRow();
+            }
+            for(auto& m : matrices)
+            {
+                auto const& s = m.getStatistics();
+                statistics[thread_index].nodes += s.nodes;
+                statistics[thread_index].linkUpdates += s.linkUpdates;
+                statistics[thread_index].solutions += s.solutions;
+            }
+        };
+        runThreads(n_threads, worker);
+
+        std::array<Table, 2> merged;
+        for(int i=0; i<n_threads; ++i)
+        {
+            for(int side=0; side<2; ++side)
+            {
+                auto& table = merged[side];
+                if(table.empty()) {
+                    table = std::move(tables[i][side]);
+                } else {
+                    for(auto const& [key, n] : tables[i][side]) { table[key] += n; }
+                }
+            }
+            m_statistics.search.nodes += statistics[i].nodes;
+            m_statistics.search.linkUpdates += statistics[i].linkUpdates;
+            m_statistics.search.solutions += statistics[i].solutions;
+        }
+        for(int side=0; side<2; ++side)
+        {
+            m_statistics.keys[side] = merged[side].size();
+            for(auto const& [key, n] : merged[side]) { m_statistics.partialTilings[side] += n; }
+        }
+
+        // the join is split across the keys of the first side, bucket by bucket
+        auto const& first = merged[0];
+        auto const& second = merged[1];
+        std::vector<std::uint64_t> counts(n_threads, 0);
+        runThreads(n_threads, [&](int thread_index) {
+            for(std::size_t b = thread_index; b < first.bucket_count(); b += n_threads)
+            {
+                for(auto it = first.begin(b); it != first.end(b); ++it)
+                {
+                    auto const match = second.find(it->first);
+                    if(match != second.end()) { counts[thread_index] += it->second * match->second; }
+                }
+            }
+        });
+        std::uint64_t ret = 0;
+        for(auto const n : counts) { ret += n; }
+        return ret;
+    }
+
+    FieldSize getFieldSize() const
+    {
+        return m_fieldSize;
+    }
+
+    Seam getSeam() const
+    {
+        return m_seam;
+    }
+
+    /*! Counters of the last call to count().
+     */
+    Statistics const& getStatistics() const
+    {
+        return m_statistics;
+    }
+
+private:
+    typedef std::array<int, ShapeCount> ShapeCounts;
+
+    /*! The crossing placements of a tiling as a bitset over their indices, followed by a count per shape.
+     */
+    typedef std::vector<std::uint64_t> Key;
+
+    struct KeyHash
+    {
+        std::size_t operator()(Key const& key) const
+        {
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            for(auto const w : key) { h = (h ^ w) * 0x100000001b3ull; h ^= h >> 29; }
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    typedef std::unordered_map<Key, std::uint64_t, KeyHash> Table;
+
+    struct RowInfo
+    {
+        int shape;
+        int crossingIndex;      ///< index among the placements crossing the seam, or -1
+    };
+
+    /*! Problem matrix of one side: one secondary column per shape, followed by one column per cell of the
+     * field. The cells of the side are primary, the cells of the other side secondary, so that placements
+     * crossing the seam may cover them.
+     */
+    struct Side
+    {
+        DLX::Matrix matrix;
+        std::vector<RowInfo> rows;
+        std::vector<int> firstCellRows;     ///< rows covering the first cell of the side
+
+        explicit Side(int nColumns)
+            :matrix(nColumns)
+        {}
+    };
+
+    int getSide(int x, int y) const
+    {
+        return ((m_seam.horizontal ? y : x) < m_seam.position) ? 0 : 1;
+    }
+
+    void buildSides()
+    {
+        int const n_columns = ShapeCount + m_fieldSize.x * m_fieldSize.y;
+        m_sides.reserve(2);
+        m_sides.emplace_back(n_columns);
+        m_sides.emplace_back(n_columns);
+        std::vector<int> occupied_fields;
+        for(int i=0; i<ShapeCount; ++i)
+        {
+            auto const s = static_cast<Shape_T>(i);
+            for(int rot=0; rot<getRotations(s); ++rot)
+            {
+                auto const placement = getPlacement(s, rot);
+                for(int x = 0; x < (m_fieldSize.x - placement.bound.x + 1); ++x)
+                {
+                    for(int y = 0; y < (m_fieldSize.y - placement.bound.y + 1); ++y)
+                    {
+                        std::array<bool, 2> covers_side{};
+                        occupied_fields.assign(1, i);
+                        for(auto const& c : placement.layout)
+                        {
+                            covers_side[getSide(x + c.x, y + c.y)] = true;
+                            occupied_fields.push_back(ShapeCount + (y + c.y) * m_fieldSize.x + x + c.x);
+                        }
+                        std::sort(begin(occupied_fields) + 1, end(occupied_fields));
+                        int const crossing_index = (covers_side[0] && covers_side[1]) ? m_crossingCount++ : -1;
+                        for(int side=0; side<2; ++side)
+                        {
+                            if(!covers_side[side]) { continue; }
+                            m_sides[side].rows.push_back(RowInfo{ i, crossing_index });
+                            m_sides[side].matrix.addRow(DLX::RowHeader(), occupied_fields);
+                        }
+                    }
+                }
+            }
+        }
+        for(int side=0; side<2; ++side)
+        {
+            auto& m = m_sides[side].matrix;
+            for(int i=0; i<ShapeCount; ++i) { m.setColumnMultiplicity(i, 1); }
+            int first_cell = -1;
+            for(int y=0; y<m_fieldSize.y; ++y)
+            {
+                for(int x=0; x<m_fieldSize.x; ++x)
+                {
+                    int const column = ShapeCount + y * m_fieldSize.x + x;
+                    if(getSide(x, y) != side) {
+                        m.setSecondaryColumn(column);
+                    } else if(first_cell < 0) {
+                        first_cell = column;
+                    }
+                }
+            }
+            std::vector<int> columns;
+            for(int r=0; r<m.getRowCount(); ++r)
+            {
+                m.getRowColumns(r, columns);
+                if(std::find(begin(columns), end(columns), first_cell) != end(columns)) {
+                    m_sides[side].firstCellRows.push_back(r);
+                }
+            }
+            m.optimizeLayout(ShapeCount);
+        }
+    }
+
+    static void applyShapeCounts(DLX::Matrix& m, ShapeCounts const& shape_counts)
+    {
+        for(int i=0; i<ShapeCount; ++i)
+        {
+            if(shape_counts[i] == 0) {
+                m.deactivateColumn(i);
+            } else {
+                m.setColumnMultiplicity(i, shape_counts[i]);
+            }
+        }
+    }
+
+    /* Key of a tiling of one side. For the first side the pieces of the crossing placements are not counted,
+     * for the second side the key holds the pieces still missing from the multiset, so that the keys of two
+     * matching tilings are equal.
+     */
+    void makeKey(int side, std::vector<RowInfo> const& rows, DLX::Matrix::Solution const& solution,
+                 ShapeCounts const& shape_counts, Key& key) const
+    {
+        std::size_t const crossing_words = (m_crossingCount + 63) / 64;
+        key.assign(crossing_words + ShapeCount, 0);
+        for(int i=0; i<ShapeCount; ++i) { key[crossing_words + i] = (side == 0) ? 0 : shape_counts[i]; }
+        for(auto const row : solution)
+        {
+            auto const& info = rows[row];
+            if(info.crossingIndex >= 0) { key[info.crossingIndex / 64] |= std::uint64_t(1) << (info.crossingIndex % 64); }
+            if(side == 0) {
+                if(info.crossingIndex < 0) { ++key[crossing_words + info.shape]; }
+            } else {
+                --key[crossing_words + info.shape];
+            }
+        }
+    }
+
+    template<typename Worker_T>
+    static void runThreads(int n_threads, Worker_T const& worker)
+    {
+        std::vector<std::thread> threads;
+        for(int i=1; i<n_threads; ++i) { threads.emplace_back(worker, i); }
+        worker(0);
+        for(auto& t : threads) { t.join(); }
+    }
+
+private:
+    FieldSize const m_fieldSize;
+    Seam const m_seam;
+    int m_crossingCount;
+    std::vector<Side> m_sides;      ///< only read during a count, the threads search on copies
+    Statistics m_statistics;
+};
+
+}
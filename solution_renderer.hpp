@@ -0,0 +1,185 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <problem_instance.hpp>
+#include <solution_writer.hpp>
+
+#include <array>
+#include <sstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Polyomino
+{
+
+/*! Renders solutions of a polyomino problem matrix as a grid of piece letters.
+ * Each chosen row is mapped to its cells directly through its columns, so rendering a solution costs
+ * O(field area + pieces * degree). The grid is written into a buffer that is reused between calls.
+ *
+ * The problem matrix is expected to have pieceColumnCount piece columns followed by one column per open cell
+ * of the board in row-major order, and row header user data pointing to the Shape_T of the piece.
+ * Blocked cells are drawn as '#', cells not covered by any piece as '.'.
+ */
+template<typename Shape_T>
+class SolutionRenderer
+{
+public:
+    SolutionRenderer(BoardMask const& board, int pieceColumnCount)
+        :m_fieldSize(board.getFieldSize()), m_pieceColumnCount(pieceColumnCount)
+    {
+        int const line_length = m_fieldSize.x + 1;
+        m_emptyGrid.assign(line_length * m_fieldSize.y, '.');
+        for(int y = 0; y < m_fieldSize.y; ++y)
+        {
+            m_emptyGrid[y * line_length + m_fieldSize.x] = '\n';
+            for(int x = 0; x < m_fieldSize.x; ++x)
+            {
+                if(board.isOpen(x, y)) {
+                    m_cellOffsets.push_back(y * line_length + x);
+                } else {
+                    m_emptyGrid[y * line_length + x] = '#';
+                }
+            }
+        }
+        initializeLabels();
+    }
+
+    /*! Render a solution, returning a reference to the internal buffer.
+     */
+    std::string const& render(DLX::Matrix const& m, DLX::Matrix::Solution const& solution)
+    {
+        m_buffer = m_emptyGrid;
+        for(auto const row : solution)
+        {
+            auto const shape = *reinterpret_cast<Shape_T const*>(m.getRowHeader(row).UserData);
+            char const label = m_labels[static_cast<int>(shape)];
+            m.getRowColumns(row, m_columns);
+            for(auto const column : m_columns)
+            {
+                if(column >= m_pieceColumnCount) { m_buffer[m_cellOffsets[column - m_pieceColumnCount]] = label; }
+            }
+        }
+        return m_buffer;
+    }
+
+    /*! Render a solution given as a list of placements, as found by LazySolver.
+     */
+    std::string const& render(std::vector<FixedPlacement<Shape_T>> const& placements)
+    {
+        m_buffer = m_emptyGrid;
+        int const line_length = m_fieldSize.x + 1;
+        for(auto const& p : placements)
+        {
+            char const label = m_labels[static_cast<int>(p.shape)];
+            for(auto const& c : getPlacement(p.shape, p.rotation).layout)
+            {
+                m_buffer[(p.y + c.y) * line_length + p.x + c.x] = label;
+            }
+        }
+        return m_buffer;
+    }
+
+private:
+    /* Shapes with single-letter names are labelled with that letter, other families (like the numbered
+     * hexominoes) with one alphanumeric character per shape.
+     */
+    void initializeLabels()
+    {
+        static char const fallback_labels[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+        bool single_letters = true;
+        std::ostringstream oss;
+        for(int i=0; i<static_cast<int>(Shape_T::END); ++i)
+        {
+            oss.str(std::string());
+            oss << static_cast<Shape_T>(i);
+            single_letters = single_letters && (oss.str().length() == 1);
+            m_labels[i] = oss.str()[0];
+        }
+        if(!single_letters) {
+            for(int i=0; i<static_cast<int>(Shape_T::END); ++i) { m_labels[i] = fallback_labels[i % (sizeof(fallback_labels) - 1)]; }
+        }
+    }
+
+private:
+    FieldSize m_fieldSize;
+    int m_pieceColumnCount;
+    std::vector<int> m_cellOffsets;         ///< offset into the grid for each open cell
+    std::array<char, static_cast<int>(Shape_T::END)> m_labels;
+    std::string m_emptyGrid;
+    std::string m_buffer;
+    std::vector<int> m_columns;
+};
+
+/*! Formats solutions as letter grids for a SolutionWriter.
+ * Rows are looked up in the matrix from the writer thread while the search is running. This is safe because
+ * the search only relinks nodes vertically, whereas the row links and column indices read here never change.
+ */
+template<typename Shape_T>
+class GridFormatter : public DLX::SolutionFormatter
+{
+public:
+    GridFormatter(DLX::Matrix const& m, BoardMask const& board, int pieceColumnCount)
+        :m_matrix(m), m_renderer(board, pieceColumnCount)
+    {}
+
+    void format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer) override
+    {
+        m_solution.assign(rows, rows + n_rows);
+        buffer += "\n *** Solution #";
+        buffer += std::to_string(solution_index);
+        buffer += ": ***\n\n";
+        buffer += m_renderer.render(m_matrix, m_solution);
+        buffer += '\n';
+    }
+
+    void end(std::uint64_t solution_count, std::string& buffer) override
+    {
+        if(solution_count == 0) { buffer += "No solution.\n"; }
+    }
+
+private:
+    DLX::Matrix const& m_matrix;
+    SolutionRenderer<Shape_T> m_renderer;
+    DLX::Matrix::Solution m_solution;
+};
+
+/*! Formats solutions as one JSON object per line, with the row indices and the rendered grid:
+ *   {"solution":1,"rows":[3,17,42],"grid":["JJZ","JZZ"]}
+ * See GridFormatter for thread safety.
+ */
+template<typename Shape_T>
+class NdjsonGridFormatter : public DLX::SolutionFormatter
+{
+public:
+    NdjsonGridFormatter(DLX::Matrix const& m, BoardMask const& board, int pieceColumnCount)
+        :m_matrix(m), m_renderer(board, pieceColumnCount)
+    {}
+
+    void format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer) override
+    {
+        m_rows.format(solution_index, rows, n_rows, buffer);
+        // reopen the object written by the row formatter to append the grid
+        buffer.resize(buffer.size() - 2);
+        buffer += ",\"grid\":[\"";
+        m_solution.assign(rows, rows + n_rows);
+        auto const& grid = m_renderer.render(m_matrix, m_solution);
+        for(std::size_t i = 0; i + 1 < grid.size(); ++i)
+        {
+            if(grid[i] == '\n') {
+                buffer += "\",\"";
+            } else {
+                buffer += grid[i];
+            }
+        }
+        buffer += "\"]}\n";
+    }
+
+private:
+    DLX::Matrix const& m_matrix;
+    SolutionRenderer<Shape_T> m_renderer;
+    DLX::NdjsonFormatter m_rows;
+    DLX::Matrix::Solution m_solution;
+};
+
+}
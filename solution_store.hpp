@@ -0,0 +1,180 @@
+#pragma once
+
+#include <DLX.hpp>
+#include <exceptions.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace DLX
+{
+    /*! Compact container for a large number of solutions of the same length.
+     * All row indices live in one flat array, stored as Index_T. Compared to a std::vector<Matrix::Solution>,
+     * this saves the per-solution vector object and heap block as well as half of the index storage for the
+     * default 16-bit indices, which is what makes enumerations with tens of millions of solutions fit into memory.
+     *
+     * Solutions of a polyomino problem all consist of the same number of placements, so the length is fixed
+     * up front. Solutions are presented as spans into the store.
+     */
+    template<typename Index_T = std::uint16_t>
+    class SolutionStore
+    {
+    public:
+        typedef std::span<Index_T const> SolutionView;
+
+        class const_iterator
+        {
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef SolutionView value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef SolutionView reference;
+
+            const_iterator()
+                :m_data(nullptr), m_length(0)
+            {}
+
+            const_iterator(Index_T const* data, std::size_t length)
+                :m_data(data), m_length(length)
+            {}
+
+            SolutionView operator*() const { return SolutionView(m_data, m_length); }
+            SolutionView operator[](difference_type n) const { return *(*this + n); }
+
+            const_iterator& operator++() { m_data += m_length; return *this; }
+            const_iterator operator++(int) { auto ret = *this; ++*this; return ret; }
+            const_iterator& operator--() { m_data -= m_length; return *this; }
+            const_iterator operator--(int) { auto ret = *this; --*this; return ret; }
+            const_iterator& operator+=(difference_type n) { m_data += n * static_cast<difference_type>(m_length); return *this; }
+            const_iterator& operator-=(difference_type n) { return *this += -n; }
+            const_iterator operator+(difference_type n) const { auto ret = *this; return ret += n; }
+            friend const_iterator operator+(difference_type n, const_iterator const& it) { return it + n; }
+            const_iterator operator-(difference_type n) const { auto ret = *this; return ret -= n; }
+            difference_type operator-(const_iterator const& rhs) const
+            {
+                return (m_length == 0) ? 0 : (m_data - rhs.m_data) / static_cast<difference_type>(m_length);
+            }
+
+            bool operator==(const_iterator const& rhs) const { return m_data == rhs.m_data; }
+            auto operator<=>(const_iterator const& rhs) const { return m_data <=> rhs.m_data; }
+
+        private:
+            Index_T const* m_data;
+            std::size_t m_length;
+        };
+
+    public:
+        /*! Create a store for solutions of solution_length rows of a matrix with nRows rows.
+         */
+        SolutionStore(int solution_length, int nRows)
+            :m_length(solution_length), m_count(0)
+        {
+            if(solution_length < 0) { PROTOCOL_VIOLATION("Invalid solution length"); }
+            if(nRows > 0 && static_cast<std::uint64_t>(nRows - 1) > std::numeric_limits<Index_T>::max()) {
+                PROTOCOL_VIOLATION("Row indices do not fit into the index type of the solution store");
+            }
+        }
+
+        void reserve(std::size_t n_solutions)
+        {
+            m_indices.reserve(n_solutions * m_length);
+        }
+
+        /*! Append a solution. Can be used directly as the body of a Matrix::SolutionCallback.
+         */
+        void push(Matrix::Solution const& solution)
+        {
+            if(solution.size() != m_length) { PROTOCOL_VIOLATION("Solution length does not match the solution store"); }
+            for(auto const row : solution) { m_indices.push_back(static_cast<Index_T>(row)); }
+            ++m_count;
+        }
+
+        std::size_t size() const
+        {
+            return m_count;
+        }
+
+        bool empty() const
+        {
+            return m_count == 0;
+        }
+
+        std::size_t getSolutionLength() const
+        {
+            return m_length;
+        }
+
+        SolutionView operator[](std::size_t i) const
+        {
+            return SolutionView(m_indices.data() + i * m_length, m_length);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(m_indices.data(), m_length);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(m_indices.data() + m_count * m_length, m_length);
+        }
+
+        Matrix::Solution getSolution(std::size_t i) const
+        {
+            auto const s = (*this)[i];
+            return Matrix::Solution(s.begin(), s.end());
+        }
+
+        /*! Bring the store into canonical form: the row indices of each solution are sorted, the solutions
+         * are sorted lexicographically and duplicates are removed.
+         * Afterwards, two stores hold the same set of solutions exactly if their contents are equal.
+         */
+        void sortUnique()
+        {
+            for(std::size_t i = 0; i < m_count; ++i)
+            {
+                auto const first = m_indices.begin() + i * m_length;
+                std::sort(first, first + m_length);
+            }
+            std::vector<std::size_t> order(m_count);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            auto const less = [this](std::size_t lhs, std::size_t rhs) {
+                auto const l = (*this)[lhs];
+                auto const r = (*this)[rhs];
+                return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+            };
+            auto const equal = [this](std::size_t lhs, std::size_t rhs) {
+                auto const l = (*this)[lhs];
+                return std::equal(l.begin(), l.end(), (*this)[rhs].begin());
+            };
+            std::sort(order.begin(), order.end(), less);
+            order.erase(std::unique(order.begin(), order.end(), equal), order.end());
+
+            std::vector<Index_T> sorted;
+            sorted.reserve(order.size() * m_length);
+            for(auto const i : order)
+            {
+                auto const s = (*this)[i];
+                sorted.insert(sorted.end(), s.begin(), s.end());
+            }
+            m_indices.swap(sorted);
+            m_count = order.size();
+        }
+
+        std::size_t getBytesUsed() const
+        {
+            return m_indices.capacity() * sizeof(Index_T);
+        }
+
+    private:
+        std::size_t m_length;
+        std::size_t m_count;
+        std::vector<Index_T> m_indices;
+    };
+}
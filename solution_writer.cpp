@@ -0,0 +1,185 @@
+#include <solution_writer.hpp>
+
+#include <exceptions.hpp>
+
+#include <algorithm>
+
+namespace DLX
+{
+namespace
+{
+char const BinaryMagic[8] = { 'D', 'L', 'X', 'S', 'O', 'L', '0', '1' };
+
+// output is handed to the operating system in chunks of this size
+std::size_t const FlushThreshold = 1 << 20;
+
+// upper bound for the memory used by the slots of a writer's queue
+std::size_t const QueueBytes = 4 << 20;
+
+// number of times a side polls the queue before it goes to sleep
+int const SpinCount = 256;
+
+template<typename T>
+void appendRaw(std::string& buffer, T value)
+{
+    buffer.append(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+}
+
+void SolutionFormatter::begin(std::string&)
+{}
+
+void SolutionFormatter::end(std::uint64_t, std::string&)
+{}
+
+void NdjsonFormatter::format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer)
+{
+    buffer += "{\"solution\":";
+    buffer += std::to_string(solution_index);
+    buffer += ",\"rows\":[";
+    for(int i=0; i<n_rows; ++i)
+    {
+        if(i != 0) { buffer += ','; }
+        buffer += std::to_string(rows[i]);
+    }
+    buffer += "]}\n";
+}
+
+BinaryFormatter::BinaryFormatter(int nRows)
+    :m_nRows(nRows), m_indexBytes((nRows <= 65536) ? 2 : 4)
+{}
+
+void BinaryFormatter::begin(std::string& buffer)
+{
+    buffer.append(BinaryMagic, sizeof(BinaryMagic));
+    appendRaw(buffer, static_cast<std::uint32_t>(m_nRows));
+    appendRaw(buffer, static_cast<std::uint32_t>(m_indexBytes));
+}
+
+void BinaryFormatter::format(std::uint64_t, int const* rows, int n_rows, std::string& buffer)
+{
+    appendRaw(buffer, static_cast<std::uint32_t>(n_rows));
+    for(int i=0; i<n_rows; ++i)
+    {
+        if(m_indexBytes == 2) {
+            appendRaw(buffer, static_cast<std::uint16_t>(rows[i]));
+        } else {
+            appendRaw(buffer, static_cast<std::uint32_t>(rows[i]));
+        }
+    }
+}
+
+SolutionQueue::SolutionQueue(std::size_t capacity, int max_solution_length)
+    :m_capacity(capacity), m_slotSize(static_cast<std::size_t>(max_solution_length) + 1),
+     m_slots(m_capacity * m_slotSize), m_head(0), m_tail(0)
+{
+    if(capacity == 0) { PROTOCOL_VIOLATION("Solution queue needs at least one slot"); }
+}
+
+void SolutionQueue::push(Matrix::Solution const& solution)
+{
+    if(solution.size() >= m_slotSize) { PROTOCOL_VIOLATION("Solution exceeds the maximum solution length"); }
+    std::uint64_t const tail = m_tail.load(std::memory_order_relaxed);
+    std::uint64_t head = m_head.load(std::memory_order_acquire);
+    for(int spin = 0; tail - head == m_capacity; ++spin)
+    {
+        if(spin < SpinCount) {
+            std::this_thread::yield();
+        } else {
+            m_head.wait(head, std::memory_order_acquire);
+        }
+        head = m_head.load(std::memory_order_acquire);
+    }
+    int* slot = &m_slots[(tail % m_capacity) * m_slotSize];
+    slot[0] = static_cast<int>(solution.size());
+    std::copy(begin(solution), end(solution), slot + 1);
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_tail.notify_one();
+}
+
+void SolutionQueue::close()
+{
+    m_tail.fetch_or(ClosedFlag, std::memory_order_release);
+    m_tail.notify_one();
+}
+
+bool SolutionQueue::pop(std::vector<int>& solution)
+{
+    std::uint64_t const head = m_head.load(std::memory_order_relaxed);
+    std::uint64_t tail = m_tail.load(std::memory_order_acquire);
+    for(int spin = 0; (tail & ~ClosedFlag) == head; ++spin)
+    {
+        if(tail & ClosedFlag) { return false; }
+        if(spin < SpinCount) {
+            std::this_thread::yield();
+        } else {
+            m_tail.wait(tail, std::memory_order_acquire);
+        }
+        tail = m_tail.load(std::memory_order_acquire);
+    }
+    int const* slot = &m_slots[(head % m_capacity) * m_slotSize];
+    solution.assign(slot + 1, slot + 1 + slot[0]);
+    m_head.store(head + 1, std::memory_order_release);
+    m_head.notify_one();
+    return true;
+}
+
+bool SolutionQueue::isEmpty() const
+{
+    return (m_tail.load(std::memory_order_acquire) & ~ClosedFlag) == m_head.load(std::memory_order_relaxed);
+}
+
+SolutionWriter::SolutionWriter(std::unique_ptr<SolutionFormatter> formatter, std::FILE* out, int max_solution_length)
+    :m_formatter(std::move(formatter)), m_out(out),
+     m_queue(std::max<std::size_t>(16, QueueBytes / ((max_solution_length + 1) * sizeof(int))), max_solution_length),
+     m_solutionCount(0)
+{
+    m_buffer.reserve(2 * FlushThreshold);
+    m_thread = std::thread([this]() { run(); });
+}
+
+SolutionWriter::~SolutionWriter()
+{
+    finish();
+}
+
+void SolutionWriter::push(Matrix::Solution const& solution)
+{
+    ++m_solutionCount;
+    m_queue.push(solution);
+}
+
+void SolutionWriter::finish()
+{
+    if(m_thread.joinable()) {
+        m_queue.close();
+        m_thread.join();
+    }
+}
+
+void SolutionWriter::run()
+{
+    m_formatter->begin(m_buffer);
+    std::vector<int> solution;
+    std::uint64_t solution_index = 0;
+    for(;;)
+    {
+        // while the search is producing solutions faster than we write them, only flush in large chunks;
+        // otherwise hand out what we have before going to sleep, so that output is not held back
+        if(m_queue.isEmpty()) { flush(); }
+        if(!m_queue.pop(solution)) { break; }
+        m_formatter->format(++solution_index, solution.data(), static_cast<int>(solution.size()), m_buffer);
+        if(m_buffer.size() >= FlushThreshold) { flush(); }
+    }
+    m_formatter->end(solution_index, m_buffer);
+    flush();
+}
+
+void SolutionWriter::flush()
+{
+    if(m_buffer.empty()) { return; }
+    std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_out);
+    std::fflush(m_out);
+    m_buffer.clear();
+}
+}
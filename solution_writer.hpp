@@ -0,0 +1,139 @@
+#pragma once
+
+#include <DLX.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DLX
+{
+    /*! Turns solutions into bytes for a SolutionWriter.
+     * All functions are called on the writer thread and append to the given buffer.
+     */
+    class SolutionFormatter
+    {
+    public:
+        virtual ~SolutionFormatter() = default;
+
+        virtual void begin(std::string& buffer);
+
+        /*! Format the solution with the 1-based index solution_index, given as n_rows row indices.
+         */
+        virtual void format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer) = 0;
+
+        virtual void end(std::uint64_t solution_count, std::string& buffer);
+    };
+
+    /*! One JSON object per line, listing the row indices of each solution:
+     *   {"solution":1,"rows":[3,17,42]}
+     */
+    class NdjsonFormatter : public SolutionFormatter
+    {
+    public:
+        void format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer) override;
+    };
+
+    /*! Dense binary stream of row indices.
+     * A 16 byte header (the magic "DLXSOL01", the number of rows of the matrix and the size of a row index
+     * in bytes, both as 32-bit integers) is followed by one record per solution: the number of rows as a
+     * 32-bit integer and the row indices, using 2 bytes each if the matrix has at most 65536 rows and 4
+     * bytes otherwise. All values are in native byte order.
+     */
+    class BinaryFormatter : public SolutionFormatter
+    {
+    public:
+        explicit BinaryFormatter(int nRows);
+
+        void begin(std::string& buffer) override;
+
+        void format(std::uint64_t solution_index, int const* rows, int n_rows, std::string& buffer) override;
+
+    private:
+        int m_nRows;
+        int m_indexBytes;
+    };
+
+    /*! Bounded lock-free queue of solutions between a single producer and a single consumer.
+     * Solutions are copied into preallocated fixed-size slots, so neither side allocates.
+     * The producer blocks while the queue is full, which throttles the search to the speed of the output.
+     */
+    class SolutionQueue
+    {
+        SolutionQueue(SolutionQueue const&)=delete;
+        SolutionQueue& operator=(SolutionQueue const&)=delete;
+    public:
+        SolutionQueue(std::size_t capacity, int max_solution_length);
+
+        /*! Append a solution, waiting for a free slot if necessary. Producer only.
+         */
+        void push(Matrix::Solution const& solution);
+
+        /*! Signal that no more solutions will be pushed. Producer only.
+         */
+        void close();
+
+        /*! Take the next solution, waiting for one if necessary. Consumer only.
+         * Returns false once the queue has been closed and drained.
+         */
+        bool pop(std::vector<int>& solution);
+
+        /*! Check whether pop() would have to wait. Consumer only.
+         */
+        bool isEmpty() const;
+
+    private:
+        static std::uint64_t const ClosedFlag = std::uint64_t(1) << 63;
+
+        std::size_t const m_capacity;
+        std::size_t const m_slotSize;
+        std::vector<int> m_slots;           ///< per slot the solution length followed by its row indices
+        alignas(64) std::atomic<std::uint64_t> m_head;     ///< number of solutions popped
+        alignas(64) std::atomic<std::uint64_t> m_tail;     ///< number of solutions pushed, plus ClosedFlag
+    };
+
+    /*! Writes solutions to a file on a dedicated thread, so the search never waits for formatting or I/O.
+     * The search pushes solutions into a bounded SolutionQueue. The writer thread formats them into a large
+     * buffer that is written out whenever it fills up, or when the queue runs empty.
+     */
+    class SolutionWriter
+    {
+        SolutionWriter(SolutionWriter const&)=delete;
+        SolutionWriter& operator=(SolutionWriter const&)=delete;
+    public:
+        /*! max_solution_length bounds the number of rows of any pushed solution.
+         */
+        SolutionWriter(std::unique_ptr<SolutionFormatter> formatter, std::FILE* out, int max_solution_length);
+
+        ~SolutionWriter();
+
+        void push(Matrix::Solution const& solution);
+
+        /*! Wait until all pushed solutions have been written. No solutions may be pushed afterwards.
+         */
+        void finish();
+
+        std::uint64_t getSolutionCount() const
+        {
+            return m_solutionCount;
+        }
+
+    private:
+        void run();
+
+        void flush();
+
+    private:
+        std::unique_ptr<SolutionFormatter> m_formatter;
+        std::FILE* m_out;
+        SolutionQueue m_queue;
+        std::uint64_t m_solutionCount;
+        std::string m_buffer;
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,165 @@
+/*! Emits specialized solvers for a set of field sizes, see bitboard_solver.hpp.
+ *
+ * For each field size, all placements of all shapes are computed from the placement tables and written out
+ * as constexpr bitboard masks, grouped by the first cell they cover. The resulting source file defines
+ * findGeneratedSolver() from generated_solvers.hpp.
+ *
+ * Usage:
+ *   solver_generator <alphabet> <output.cpp> [<width>x<height> ...]
+ */
+#include <polyomino.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+bool parseFieldSize(std::string const& str, Polyomino::FieldSize& field_size)
+{
+    std::istringstream iss(str);
+    char separator;
+    if(!(iss >> field_size.x >> separator >> field_size.y) || separator != 'x' || !iss.eof()) { return false; }
+    return field_size.x > 0 && field_size.y > 0 && field_size.x * field_size.y <= 64;
+}
+
+std::string getFieldName(Polyomino::FieldSize const& field_size)
+{
+    return "Field_" + std::to_string(field_size.x) + "x" + std::to_string(field_size.y);
+}
+
+template<typename Shape_T>
+void writeField(std::ostream& os, Polyomino::FieldSize const& field_size)
+{
+    struct Candidate
+    {
+        std::uint64_t mask;
+        int shape;
+        int rotation;
+        int x;
+        int y;
+    };
+    std::vector<Candidate> candidates;
+    for(int s=0; s<static_cast<int>(Shape_T::END); ++s)
+    {
+        auto const shape = static_cast<Shape_T>(s);
+        for(int rot=0; rot<getRotations(shape); ++rot)
+        {
+            auto const placement = getPlacement(shape, rot);
+            for(int x = 0; x < (field_size.x - placement.bound.x + 1); ++x)
+            {
+                for(int y = 0; y < (field_size.y - placement.bound.y + 1); ++y)
+                {
+                    std::uint64_t mask = 0;
+                    for(auto const& c : placement.layout)
+                    {
+                        mask |= std::uint64_t(1) << ((y + c.y) * field_size.x + x + c.x);
+                    }
+                    candidates.push_back(Candidate{ mask, s, rot, x, y });
+                }
+            }
+        }
+    }
+    std::stable_sort(begin(candidates), end(candidates), [](Candidate const& lhs, Candidate const& rhs) {
+        return std::countr_zero(lhs.mask) < std::countr_zero(rhs.mask);
+    });
+
+    int const cell_count = field_size.x * field_size.y;
+    os << "struct " << getFieldName(field_size) << "\n"
+       << "{\n"
+       << "    static constexpr int Width = " << field_size.x << ";\n"
+       << "    static constexpr int Height = " << field_size.y << ";\n"
+       << "    static constexpr Polyomino::BitboardCandidate Candidates[] = {\n";
+    for(auto const& c : candidates)
+    {
+        os << "        { 0x" << std::hex << c.mask << std::dec << "ull, " << c.shape << ", " << c.rotation << ", "
+           << c.x << ", " << c.y << " },     // " << static_cast<Shape_T>(c.shape) << '\n';
+    }
+    os << "    };\n"
+       << "    static constexpr int CandidateBegin[" << cell_count + 1 << "] = {";
+    std::size_t index = 0;
+    for(int cell = 0; cell <= cell_count; ++cell)
+    {
+        while(index < candidates.size() && std::countr_zero(candidates[index].mask) < cell) { ++index; }
+        os << ((cell % 16 == 0) ? "\n        " : " ") << index << ((cell < cell_count) ? "," : "");
+    }
+    os << "\n    };\n"
+       << "};\n\n";
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 3)
+    {
+        std::cout << "Usage: \n"
+                  << "  solver_generator <alphabet> <output.cpp> [<width>x<height> ...]\n"
+                  << "    (alphabet is tetromino, the one-sided tetrominoes; fields may have at most 64 cells)\n"
+                  << std::endl;
+        return 1;
+    }
+    if(std::string(argv[1]) != "tetromino") {
+        std::cerr << "Unsupported alphabet \'" << argv[1] << "\'" << std::endl;
+        return 1;
+    }
+    std::vector<Polyomino::FieldSize> field_sizes;
+    for(int i=3; i<argc; ++i)
+    {
+        Polyomino::FieldSize field_size;
+        if(!parseFieldSize(argv[i], field_size)) {
+            std::cerr << "Invalid field size \'" << argv[i] << "\'" << std::endl;
+            return 1;
+        }
+        auto const same_size = [&field_size](Polyomino::FieldSize const& f) { return f.x == field_size.x && f.y == field_size.y; };
+        if(std::none_of(begin(field_sizes), end(field_sizes), same_size)) { field_sizes.push_back(field_size); }
+    }
+
+    std::ostringstream os;
+    os << "// Generated by solver_generator, do not edit.\n"
+       << "#include <bitboard_solver.hpp>\n"
+       << "#include <generated_solvers.hpp>\n"
+       << "\n"
+       << "namespace Tetromino\n"
+       << "{\n"
+       << "namespace OneSided\n"
+       << "{\n"
+       << "namespace\n"
+       << "{\n";
+    for(auto const& field_size : field_sizes) { writeField<Tetromino::OneSided::Shape>(os, field_size); }
+    os << "template<typename Field_T>\n"
+       << "DLX::SearchStatistics solveField(std::vector<Shape> const& pieces, GeneratedSolverCallback const& callback)\n"
+       << "{\n"
+       << "    Polyomino::BitboardSolver<Shape, Field_T> solver(pieces);\n"
+       << "    solver.solveAll(callback);\n"
+       << "    return solver.getStatistics();\n"
+       << "}\n"
+       << "}\n"
+       << "\n"
+       << "GeneratedSolver findGeneratedSolver(Polyomino::FieldSize const& field_size)\n"
+       << "{\n";
+    for(auto const& field_size : field_sizes)
+    {
+        os << "    if(field_size.x == " << field_size.x << " && field_size.y == " << field_size.y << ") { return &solveField<"
+           << getFieldName(field_size) << ">; }\n";
+    }
+    os << "    (void)field_size;\n"
+       << "    return nullptr;\n"
+       << "}\n"
+       << "}\n"
+       << "}\n";
+
+    std::ofstream fout(argv[2], std::ios::binary);
+    fout << os.str();
+    if(!fout) {
+        std::cerr << "File could not be written: " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}
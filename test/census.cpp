@@ -0,0 +1,113 @@
+/*! Cross-check of Polyomino::Census against the tilings found by Polyomino::MasterMatrix.
+ *
+ * Runs the census on small fields with one and several threads, and compares the table with the number of
+ * tilings of every piece multiset, counted one multiset at a time on the master matrix.
+ *
+ * Usage:
+ *   census_test
+ */
+#include <census.hpp>
+#include <master_matrix.hpp>
+#include <tetromino.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Tetromino::OneSided::Shape;
+typedef Polyomino::Census<Shape> Census;
+
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+std::string getName(Polyomino::FieldSize const& field_size)
+{
+    return std::to_string(field_size.x) + "x" + std::to_string(field_size.y);
+}
+
+/* Calls f for every multiset of n_pieces shapes.
+ */
+void forEachMultiset(int n_pieces, std::function<void(Census::ShapeCounts const&)> const& f)
+{
+    Census::ShapeCounts counts{};
+    std::function<void(int, int)> recurse = [&](int shape, int remaining) {
+        if(shape == Census::ShapeCount - 1) {
+            counts[shape] = remaining;
+            f(counts);
+            return;
+        }
+        for(int n = 0; n <= remaining; ++n)
+        {
+            counts[shape] = n;
+            recurse(shape + 1, remaining - n);
+        }
+    };
+    recurse(0, n_pieces);
+}
+
+void testField(Polyomino::FieldSize const& field_size)
+{
+    Census census(field_size);
+    census.run(1);
+    auto const table = census.getTable();
+    auto const tiling_count = census.getTilingCount();
+
+    auto& master = Polyomino::MasterMatrix<Shape>::getCached(field_size);
+    int const n_pieces = field_size.x * field_size.y / Polyomino::Degree<Shape>::value;
+    std::uint64_t total = 0;
+    int n_multisets = 0;
+    int n_mismatches = 0;
+    forEachMultiset(n_pieces, [&](Census::ShapeCounts const& counts) {
+        std::vector<Shape> pieces;
+        for(int i=0; i<Census::ShapeCount; ++i) { pieces.insert(pieces.end(), counts[i], static_cast<Shape>(i)); }
+        std::uint64_t expected = 0;
+        master.solveAll(pieces, [&expected](DLX::Matrix::Solution const&) { ++expected; return true; });
+        auto const it = table.find(counts);
+        auto const actual = (it == table.end()) ? 0 : it->second;
+        if(actual != expected) { ++n_mismatches; }
+        if(expected > 0) { ++n_multisets; }
+        total += expected;
+    });
+    auto const name = getName(field_size);
+    check(n_mismatches == 0, name + ": census counts match the master matrix for every multiset");
+    check(static_cast<int>(table.size()) == n_multisets, name + ": census lists exactly the tileable multisets");
+    check(tiling_count == total, name + ": total tiling count");
+
+    Census parallel(field_size);
+    parallel.run(3);
+    check(parallel.getTable() == table && parallel.getTilingCount() == tiling_count,
+          name + ": census on several threads matches the single thread");
+    std::cout << name << ": " << tiling_count << " tilings of " << table.size() << " multisets\n";
+}
+}
+
+int main()
+{
+    testField(Polyomino::FieldSize{ 4, 4 });
+    testField(Polyomino::FieldSize{ 4, 5 });
+
+    // the 4x4 square is tiled by four I pieces either in rows or in columns, and by four O pieces in one way
+    Census census(Polyomino::FieldSize{ 4, 4 });
+    census.run();
+    Census::ShapeCounts i_pieces{};
+    i_pieces[static_cast<int>(Shape::I)] = 4;
+    Census::ShapeCounts o_pieces{};
+    o_pieces[static_cast<int>(Shape::O)] = 4;
+    check(census.getTable().count(i_pieces) && census.getTable().at(i_pieces) == 2, "4x4 IIII has 2 tilings");
+    check(census.getTable().count(o_pieces) && census.getTable().at(o_pieces) == 1, "4x4 OOOO has 1 tiling");
+    check(census.getTilingCount() == 117 && census.getTable().size() == 24, "4x4 has 117 tilings of 24 multisets");
+
+    if(failures == 0) { std::cout << "All census tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/*! Cross-check of the solvers generated at build time against the generic engine.
+ *
+ * For each generated field size, solves random piece multisets with the generated solver and with the
+ * problem matrix that tetromino_solver --generic uses, and compares the tilings as rendered grids.
+ * The problem matrix has a column for every piece, so it finds each tiling once for every assignment of
+ * identical pieces, whereas the generated solver finds it once.
+ *
+ * Usage:
+ *   generated_solvers_test <width>x<height> ...
+ */
+#include <DLX.hpp>
+#include <generated_solvers.hpp>
+#include <problem_instance.hpp>
+#include <solution_renderer.hpp>
+#include <tetromino.hpp>
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Tetromino::OneSided::Shape;
+
+std::uint64_t countPieceAssignments(std::vector<Shape> const& pieces)
+{
+    std::array<int, static_cast<int>(Shape::END)> counts{};
+    for(auto const s : pieces) { ++counts[static_cast<int>(s)]; }
+    std::uint64_t ret = 1;
+    for(auto const n : counts)
+    {
+        for(int i=2; i<=n; ++i) { ret *= i; }
+    }
+    return ret;
+}
+
+/* Number of times each grid was found by the generated solver.
+ */
+std::map<std::string, std::uint64_t> solveGenerated(Tetromino::OneSided::GeneratedSolver solver,
+                                                    Polyomino::FieldSize const& field_size,
+                                                    std::vector<Shape> const& pieces)
+{
+    Polyomino::SolutionRenderer<Shape> renderer(Polyomino::BoardMask(field_size), static_cast<int>(pieces.size()));
+    std::map<std::string, std::uint64_t> ret;
+    solver(pieces, [&](std::vector<Polyomino::FixedPlacement<Shape>> const& solution) {
+        ++ret[renderer.render(solution)];
+        return true;
+    });
+    return ret;
+}
+
+/* Number of times each grid was found by the generic engine.
+ */
+std::map<std::string, std::uint64_t> solveGeneric(Polyomino::FieldSize const& field_size,
+                                                  std::vector<Shape> const& pieces)
+{
+    Polyomino::ProblemInstance<Shape> problem(field_size);
+    for(auto const s : pieces) { problem.addPiece(s); }
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    Polyomino::SolutionRenderer<Shape> renderer(problem.getBoard(), problem.getPieceColumnCount());
+    std::map<std::string, std::uint64_t> ret;
+    m.solveAll([&](DLX::Matrix::Solution const& solution) {
+        ++ret[renderer.render(m, solution)];
+        return true;
+    });
+    return ret;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        std::cout << "Usage: \n"
+                  << "  generated_solvers_test <width>x<height> ...\n"
+                  << std::endl;
+        return 1;
+    }
+    // std::minstd_rand without distributions, so that the multisets are the same on every platform
+    std::minstd_rand rng(20240704);
+    int failures = 0;
+    for(int arg=1; arg<argc; ++arg)
+    {
+        Polyomino::FieldSize field_size{ 0, 0 };
+        char separator = 0;
+        std::istringstream iss(argv[arg]);
+        iss >> field_size.x >> separator >> field_size.y;
+        auto const solver = Tetromino::OneSided::findGeneratedSolver(field_size);
+        if(!solver) {
+            std::cout << "FAILED: no generated solver for " << argv[arg] << '\n';
+            ++failures;
+            continue;
+        }
+
+        // the generic engine enumerates every assignment of identical pieces, so multisets with many
+        // identical pieces are skipped to keep the test fast
+        int const n_pieces = (field_size.x * field_size.y) / Polyomino::Degree<Shape>::value;
+        int n_tileable = 0;
+        bool has_untileable = false;
+        for(int attempt=0; attempt<500 && (n_tileable < 3 || !has_untileable); ++attempt)
+        {
+            std::vector<Shape> pieces;
+            for(int i=0; i<n_pieces; ++i) { pieces.push_back(static_cast<Shape>(rng() % static_cast<int>(Shape::END))); }
+            auto const copies = countPieceAssignments(pieces);
+            if(copies > 8) { continue; }
+
+            auto const generated = solveGenerated(solver, field_size, pieces);
+            if(!generated.empty() && n_tileable < 3) {
+                ++n_tileable;
+            } else if(generated.empty() && !has_untileable) {
+                has_untileable = true;
+            } else {
+                continue;
+            }
+            auto const generic = solveGeneric(field_size, pieces);
+
+            bool match = (generated.size() == generic.size());
+            for(auto const& [grid, n] : generated)
+            {
+                auto const it = generic.find(grid);
+                match = match && (it != generic.end()) && (it->second == n * copies);
+            }
+            std::cout << argv[arg] << " ";
+            for(auto const s : pieces) { std::cout << s; }
+            std::cout << ": " << generated.size() << " tilings";
+            if(!match) {
+                std::cout << " - FAILED: generic engine found " << generic.size() << " distinct tilings\n";
+                ++failures;
+            } else {
+                std::cout << " - ok\n";
+            }
+        }
+        if(n_tileable == 0) {
+            std::cout << "FAILED: no tileable multiset found for " << argv[arg] << '\n';
+            ++failures;
+        }
+    }
+    std::cout << std::flush;
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/*! Cross-check of Polyomino::LazySolver against the problem matrix.
+ *
+ * Solves random piece multisets on a few fields, surplus inventories and a board with blocked cells, both with
+ * the lazy solver and with the problem matrix of ProblemInstance, and compares the sets of tilings. For exact
+ * inventories the problem matrix finds a tiling once for every assignment of identical pieces, for surplus
+ * inventories it groups identical pieces and finds each tiling once. The lazy solver must find it exactly once.
+ *
+ * Usage:
+ *   lazy_solver_test
+ */
+#include <DLX.hpp>
+#include <lazy_solver.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using Tetromino::OneSided::Shape;
+
+/* A tiling as the shape and the covered cells of each placement, independent of the order of the placements
+ * and of which copy of a shape was used.
+ */
+typedef std::vector<std::pair<int, std::vector<int>>> Tiling;
+
+std::vector<Tiling> solveGeneric(Polyomino::ProblemInstance<Shape> const& problem)
+{
+    auto const field_size = problem.getFieldSize();
+    std::map<int, int> cells_by_column;
+    for(int y = 0; y < field_size.y; ++y)
+    {
+        for(int x = 0; x < field_size.x; ++x)
+        {
+            int const column = problem.getCellColumn(x, y);
+            if(column != -1) { cells_by_column[column] = y * field_size.x + x; }
+        }
+    }
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    std::vector<Tiling> ret;
+    std::vector<int> columns;
+    m.solveAll([&](DLX::Matrix::Solution const& solution) {
+        Tiling tiling;
+        for(auto const row : solution)
+        {
+            auto const shape = *static_cast<Shape const*>(m.getRowHeader(row).UserData);
+            std::vector<int> cells;
+            m.getRowColumns(row, columns);
+            for(auto const c : columns)
+            {
+                auto const it = cells_by_column.find(c);
+                if(it != cells_by_column.end()) { cells.push_back(it->second); }
+            }
+            tiling.emplace_back(static_cast<int>(shape), cells);
+        }
+        std::sort(begin(tiling), end(tiling));
+        ret.push_back(tiling);
+        return true;
+    });
+    return ret;
+}
+
+std::vector<Tiling> solveLazily(Polyomino::ProblemInstance<Shape> const& problem)
+{
+    auto const field_size = problem.getFieldSize();
+    Polyomino::LazySolver<Shape> solver(problem);
+    std::vector<Tiling> ret;
+    solver.solveAll([&](Polyomino::LazySolver<Shape>::Solution const& solution) {
+        Tiling tiling;
+        for(auto const& p : solution)
+        {
+            std::vector<int> cells;
+            for(auto const& c : Tetromino::OneSided::getPlacement(p.shape, p.rotation).layout)
+            {
+                cells.push_back((p.y + c.y) * field_size.x + p.x + c.x);
+            }
+            std::sort(begin(cells), end(cells));
+            tiling.emplace_back(static_cast<int>(p.shape), cells);
+        }
+        std::sort(begin(tiling), end(tiling));
+        ret.push_back(tiling);
+        return true;
+    });
+    return ret;
+}
+
+/* Returns the number of tilings, or -1 if the solvers disagree.
+ */
+int compare(Polyomino::BoardMask const& board, std::vector<Shape> const& pieces)
+{
+    Polyomino::ProblemInstance<Shape> problem(board);
+    for(auto const s : pieces) { problem.addPiece(s); }
+    auto const generic = solveGeneric(problem);
+    auto const lazy = solveLazily(problem);
+    std::set<Tiling> const generic_set(begin(generic), end(generic));
+    std::set<Tiling> const lazy_set(begin(lazy), end(lazy));
+    if(lazy_set.size() != lazy.size() || lazy_set != generic_set) { return -1; }
+    if(problem.hasSurplusPieces() && generic.size() != generic_set.size()) { return -1; }
+    return static_cast<int>(lazy.size());
+}
+}
+
+int main()
+{
+    int failures = 0;
+    auto const report = [&failures](std::string const& name, std::vector<Shape> const& pieces, int n) {
+        std::cout << name << " ";
+        for(auto const s : pieces) { std::cout << s; }
+        std::cout << ": ";
+        if(n < 0) {
+            std::cout << "FAILED: lazy solver and problem matrix disagree\n";
+            ++failures;
+        } else {
+            std::cout << n << " tilings - ok\n";
+        }
+    };
+
+    // exact inventories: a few random multisets with tilings on each field,
+    // using std::minstd_rand without distributions, so that the multisets are the same on every platform
+    std::minstd_rand rng(20240801);
+    struct { int x; int y; } const sizes[] = { {4, 4}, {4, 5}, {6, 4}, {6, 6} };
+    for(auto const& size : sizes)
+    {
+        Polyomino::FieldSize const field_size{ size.x, size.y };
+        int const n_pieces = (size.x * size.y) / Polyomino::Degree<Shape>::value;
+        int n_tileable = 0;
+        for(int attempt=0; attempt<500 && n_tileable < 3; ++attempt)
+        {
+            std::vector<Shape> pieces;
+            for(int i=0; i<n_pieces; ++i) { pieces.push_back(static_cast<Shape>(rng() % static_cast<int>(Shape::END))); }
+            std::sort(begin(pieces), end(pieces));
+            // the problem matrix enumerates every assignment of identical pieces, keep that small
+            std::array<int, static_cast<int>(Shape::END)> counts{};
+            for(auto const s : pieces) { ++counts[static_cast<int>(s)]; }
+            if(*std::max_element(begin(counts), end(counts)) > 2) { continue; }
+            auto const n = compare(Polyomino::BoardMask(field_size), pieces);
+            if(n == 0) { continue; }
+            ++n_tileable;
+            report(std::to_string(size.x) + "x" + std::to_string(size.y), pieces, n);
+        }
+        if(n_tileable == 0) {
+            std::cout << "FAILED: no tileable multiset found for " << size.x << "x" << size.y << '\n';
+            ++failures;
+        }
+    }
+
+    // surplus inventories, where any subset of the pieces that fills the field is a solution
+    std::vector<std::vector<Shape>> const surplus = {
+        { Shape::I, Shape::I, Shape::I, Shape::I, Shape::O, Shape::O, Shape::T, Shape::T },
+        { Shape::I, Shape::O, Shape::T, Shape::J, Shape::L, Shape::S, Shape::Z },
+        { Shape::L, Shape::L, Shape::J, Shape::J, Shape::T, Shape::O },
+    };
+    for(auto const& pieces : surplus)
+    {
+        report("4x4", pieces, compare(Polyomino::BoardMask(Polyomino::FieldSize{ 4, 4 }), pieces));
+    }
+
+    // a board with blocked cells
+    Polyomino::BoardMask ring(Polyomino::FieldSize{ 6, 6 });
+    for(auto const& [x, y] : { std::make_pair(2, 2), std::make_pair(3, 2), std::make_pair(2, 3), std::make_pair(3, 3) })
+    {
+        ring.blockCell(x, y);
+    }
+    std::vector<Shape> const ring_pieces = { Shape::T, Shape::T, Shape::T, Shape::T, Shape::L, Shape::L, Shape::J, Shape::J };
+    report("6x6 ring", ring_pieces, compare(ring, ring_pieces));
+
+    std::cout << std::flush;
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/*! Round-trip tests for the text and the compiled binary matrix file formats.
+ *
+ * Compiles text matrices to the binary format, reloads them and compares the sparse structure and the solutions
+ * with the original, and checks that malformed files of both formats are rejected with an error.
+ *
+ * Usage:
+ *   matrix_file_test <matrix_file>
+ */
+#include <DLX.hpp>
+#include <matrix_file.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+std::string getTemporaryFile(std::string const& name)
+{
+    return (std::filesystem::temp_directory_path() / ("matrix_file_test_" + name)).string();
+}
+
+void writeFile(std::string const& filename, std::string const& contents)
+{
+    std::ofstream fout(filename, std::ios::binary);
+    fout << contents;
+}
+
+std::string readFile(std::string const& filename)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+}
+
+bool sameStructure(DLX::SparseMatrix const& lhs, DLX::SparseMatrix const& rhs)
+{
+    if(lhs.nColumns != rhs.nColumns || lhs.nRows != rhs.nRows) { return false; }
+    if(!std::equal(lhs.rowOffsets, lhs.rowOffsets + lhs.nRows + 1, rhs.rowOffsets)) { return false; }
+    return std::equal(lhs.columnIndices, lhs.columnIndices + lhs.rowOffsets[lhs.nRows], rhs.columnIndices);
+}
+
+std::vector<DLX::Matrix::Solution> sortedSolutions(DLX::Matrix& m)
+{
+    auto ret = m.solveAll();
+    for(auto& s : ret) { std::sort(begin(s), end(s)); }
+    std::sort(begin(ret), end(ret));
+    return ret;
+}
+
+/* Loads a text matrix, compiles it and loads the binary file. Returns false if any step fails.
+ */
+bool compile(std::string const& text_file, std::string const& binary_file, DLX::MatrixFile& text,
+             DLX::MatrixFile& binary)
+{
+    std::string error;
+    if(!text.load(text_file, error)) {
+        check(false, "text matrix " + text_file + " could not be loaded: " + error);
+        return false;
+    }
+    check(!text.isBinary(), "text matrix is detected as text");
+    if(!DLX::writeBinaryMatrix(text.getMatrix(), binary_file)) {
+        check(false, "binary matrix " + binary_file + " could not be written");
+        return false;
+    }
+    if(!binary.load(binary_file, error)) {
+        check(false, "compiled matrix " + binary_file + " could not be loaded: " + error);
+        return false;
+    }
+    check(binary.isBinary(), "compiled matrix is detected as binary");
+    return true;
+}
+
+void testMatrixFile(std::string const& filename)
+{
+    DLX::MatrixFile text;
+    DLX::MatrixFile binary;
+    if(!compile(filename, getTemporaryFile("compiled.bin"), text, binary)) { return; }
+    check(text.getMatrix().nRows > 0, "matrix file has rows");
+    check(sameStructure(text.getMatrix(), binary.getMatrix()), "compiled matrix has the rows of the text matrix");
+}
+
+void testSolutions()
+{
+    using namespace Tetromino::OneSided;
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    for(auto const s : { Shape::T, Shape::T, Shape::O, Shape::O, Shape::I, Shape::J, Shape::L, Shape::L, Shape::S })
+    {
+        problem.addPiece(s);
+    }
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    int const n_columns = problem.getPieceColumnCount() + problem.getBoard().getOpenCellCount();
+    std::string contents;
+    std::vector<int> columns;
+    for(int i=0; i<m.getRowCount(); ++i)
+    {
+        m.getRowColumns(i, columns);
+        std::string line(n_columns, '0');
+        for(auto const c : columns) { line[c] = '1'; }
+        // line endings of both kinds and empty lines are accepted
+        contents += line + ((i % 2) ? "\r\n" : "\n");
+        if(i % 100 == 0) { contents += '\n'; }
+    }
+    auto const text_file = getTemporaryFile("problem.txt");
+    writeFile(text_file, contents);
+
+    DLX::MatrixFile text;
+    DLX::MatrixFile binary;
+    if(!compile(text_file, getTemporaryFile("problem.bin"), text, binary)) { return; }
+    check(text.getMatrix().nRows == m.getRowCount() && text.getMatrix().nColumns == n_columns,
+          "text matrix has the size of the problem matrix");
+    auto const expected = sortedSolutions(m);
+    DLX::Matrix from_text = DLX::createMatrix(text.getMatrix());
+    DLX::Matrix from_binary = DLX::createMatrix(binary.getMatrix());
+    check(!expected.empty() && sortedSolutions(from_text) == expected, "text matrix has the solutions of the problem");
+    check(sortedSolutions(from_binary) == expected, "compiled matrix has the solutions of the problem");
+}
+
+bool loadFails(std::string const& name, std::string const& contents)
+{
+    auto const filename = getTemporaryFile(name);
+    writeFile(filename, contents);
+    DLX::MatrixFile matrix_file;
+    std::string error;
+    return !matrix_file.load(filename, error) && !error.empty();
+}
+
+void setUint32(std::string& data, std::size_t offset, std::uint32_t value)
+{
+    std::memcpy(&data[offset], &value, sizeof(value));
+}
+
+void testMalformedFiles()
+{
+    check(loadFails("empty.txt", ""), "empty text matrix is rejected");
+    check(loadFails("lengths.txt", "0110\n101\n"), "text rows of different lengths are rejected");
+    check(loadFails("character.txt", "0110\n1021\n"), "invalid character in text matrix is rejected");
+
+    // two columns and the rows {0, 1} and {1}: the header, the offsets 0, 2, 3 and the indices 0, 1, 1
+    auto const text_file = getTemporaryFile("small.txt");
+    auto const binary_file = getTemporaryFile("small.bin");
+    writeFile(text_file, "11\n01\n");
+    DLX::MatrixFile text;
+    DLX::MatrixFile binary;
+    if(!compile(text_file, binary_file, text, binary)) { return; }
+    auto const data = readFile(binary_file);
+    std::size_t const offsets = 24;
+    std::size_t const indices = offsets + 3 * sizeof(std::uint32_t);
+    check(data.size() == indices + 3 * sizeof(std::uint32_t), "binary matrix has the documented size");
+
+    check(loadFails("truncated_header.bin", data.substr(0, 20)), "truncated binary header is rejected");
+    check(loadFails("truncated.bin", data.substr(0, data.size() - 1)), "truncated binary matrix is rejected");
+    check(loadFails("trailing.bin", data + std::string(4, '\0')), "binary matrix with trailing data is rejected");
+
+    auto corrupted = data;
+    setUint32(corrupted, indices + 4, 2);
+    check(loadFails("column.bin", corrupted), "column index out of range is rejected");
+
+    corrupted = data;
+    setUint32(corrupted, offsets + 4, 4);
+    check(loadFails("offsets.bin", corrupted), "decreasing row offsets are rejected");
+
+    corrupted = data;
+    setUint32(corrupted, offsets, 1);
+    check(loadFails("first_offset.bin", corrupted), "row offsets not starting at zero are rejected");
+
+    corrupted = data;
+    setUint32(corrupted, 8, 0x80000000u);
+    check(loadFails("columns.bin", corrupted), "column count above the int range is rejected");
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 2)
+    {
+        std::cout << "Usage: \n"
+                  << "  matrix_file_test <matrix_file>\n"
+                  << std::endl;
+        return 1;
+    }
+    testMatrixFile(argv[1]);
+    testSolutions();
+    testMalformedFiles();
+    if(failures == 0) { std::cout << "All matrix file tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+/*! Tests for DLX::Matrix::serialize() and DLX::Matrix::deserialize().
+ *
+ * Checks that a matrix with selected rows and deactivated columns reads back with the same solutions, and that
+ * corrupted streams are rejected with std::runtime_error instead of producing a matrix with broken links.
+ *
+ * Usage:
+ *   matrix_serialization_test
+ */
+#include <DLX.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+std::string serialize(DLX::Matrix const& m)
+{
+    std::ostringstream oss;
+    m.serialize(oss);
+    return oss.str();
+}
+
+std::vector<DLX::Matrix::Solution> sortedSolutions(DLX::Matrix& m)
+{
+    auto ret = m.solveAll();
+    for(auto& s : ret) { std::sort(begin(s), end(s)); }
+    std::sort(begin(ret), end(ret));
+    return ret;
+}
+
+bool deserializationThrows(std::string const& data)
+{
+    std::istringstream iss(data);
+    try {
+        DLX::Matrix::deserialize(iss);
+    } catch(std::runtime_error const&) {
+        return true;
+    }
+    return false;
+}
+
+void setInt(std::string& data, std::size_t offset, std::int32_t value)
+{
+    std::memcpy(&data[offset], &value, sizeof(value));
+}
+
+void testRoundTrip()
+{
+    using namespace Tetromino::OneSided;
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    for(auto const s : { Shape::T, Shape::T, Shape::O, Shape::O, Shape::I, Shape::J, Shape::L, Shape::L, Shape::S })
+    {
+        problem.addPiece(s);
+    }
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    auto const first = m.solveAll().front();
+    m.selectRow(first.back());
+
+    std::istringstream iss(serialize(m));
+    DLX::Matrix copy = DLX::Matrix::deserialize(iss);
+    check(copy.getRowCount() == m.getRowCount(), "deserialized matrix has the same rows");
+    check(copy.getSelectedRows() == m.getSelectedRows(), "deserialized matrix has the same selected rows");
+    auto const expected = sortedSolutions(m);
+    check(!expected.empty() && sortedSolutions(copy) == expected, "deserialized matrix has the same solutions");
+    copy.unselectRow();
+    m.unselectRow();
+    check(sortedSolutions(copy) == sortedSolutions(m), "unselecting in the deserialized matrix restores its state");
+
+    DLX::Matrix small(3);
+    small.addRow(DLX::RowHeader(), std::vector<int>{ 0, 1 });
+    small.addRow(DLX::RowHeader(), std::vector<int>{ 2 });
+    small.addRow(DLX::RowHeader(), std::vector<int>{ 1 });
+    small.deactivateColumn(0);
+    std::istringstream small_iss(serialize(small));
+    DLX::Matrix small_copy = DLX::Matrix::deserialize(small_iss);
+    check(sortedSolutions(small_copy) == sortedSolutions(small), "deactivated columns are restored");
+    small_copy.reactivateColumns();
+    small.reactivateColumns();
+    check(sortedSolutions(small_copy) == sortedSolutions(small), "reactivating in the deserialized matrix");
+}
+
+void testCorruptedStreams()
+{
+    // columns 0 to 2 with rows {0, 1}, {1, 2} and {2}; nodes are numbered as in Matrix::serialize()
+    DLX::Matrix m(3);
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0, 1 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 1, 2 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 2 });
+    auto const data = serialize(m);
+    check(!deserializationThrows(data), "valid stream is accepted");
+
+    // magic, column and row counts, then the row sizes and columns
+    std::size_t const row0_columns = 16;
+    // after the rows: the header list links of the matrix header, then six values per column header
+    std::size_t const column0 = 44 + 8;
+    std::size_t const column0_count = column0;
+    std::size_t const column0_next = column0 + 8;
+
+    auto corrupted = data;
+    setInt(corrupted, row0_columns, 1);
+    setInt(corrupted, row0_columns + 4, 0);
+    check(deserializationThrows(corrupted), "unsorted columns in a row are rejected");
+
+    corrupted = data;
+    setInt(corrupted, row0_columns + 4, 0);
+    check(deserializationThrows(corrupted), "duplicate columns in a row are rejected");
+
+    corrupted = data;
+    setInt(corrupted, row0_columns + 4, 3);
+    check(deserializationThrows(corrupted), "column index out of range is rejected");
+
+    corrupted = data;
+    setInt(corrupted, column0_next, 3);
+    check(deserializationThrows(corrupted), "column link to another column header is rejected");
+
+    corrupted = data;
+    setInt(corrupted, column0_next, 6);
+    check(deserializationThrows(corrupted), "column link to an element of another column is rejected");
+
+    corrupted = data;
+    setInt(corrupted, column0_next, 1);
+    check(deserializationThrows(corrupted), "column list that skips its elements is rejected");
+
+    corrupted = data;
+    setInt(corrupted, column0_count, 2);
+    check(deserializationThrows(corrupted), "column count that differs from the column list is rejected");
+
+    corrupted = data;
+    setInt(corrupted, 44, 2);
+    check(deserializationThrows(corrupted), "header list that skips a column is rejected");
+
+    check(deserializationThrows(data + '\0'), "trailing data is rejected");
+    check(deserializationThrows(data.substr(0, data.size() - 1)), "truncated stream is rejected");
+}
+}
+
+int main()
+{
+    testRoundTrip();
+    testCorruptedStreams();
+    if(failures == 0) { std::cout << "All matrix serialization tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/*! Tests for DLX::Matrix::optimizeLayout().
+ *
+ * Rebuilds the rows of problem matrices in their original order and checks that relaying them out keeps the
+ * row indices, the columns and the user data of every row and the solutions, also for rows selected and
+ * columns deactivated around the relayout, and for fixed placements that ProblemInstance selects afterwards.
+ *
+ * Usage:
+ *   optimize_layout_test
+ */
+#include <DLX.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Tetromino::OneSided::Shape;
+
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+std::vector<DLX::Matrix::Solution> sortedSolutions(DLX::Matrix& m)
+{
+    auto ret = m.solveAll();
+    for(auto& s : ret) { std::sort(begin(s), end(s)); }
+    std::sort(begin(ret), end(ret));
+    return ret;
+}
+
+/* A matrix with the rows of m added in order of their index, as they are before the relayout.
+ */
+DLX::Matrix rebuildRows(DLX::Matrix const& m, int nColumns)
+{
+    DLX::Matrix ret(nColumns);
+    std::vector<int> columns;
+    for(int i=0; i<m.getRowCount(); ++i)
+    {
+        m.getRowColumns(i, columns);
+        ret.addRow(m.getRowHeader(i), columns);
+    }
+    return ret;
+}
+
+bool sameRows(DLX::Matrix const& lhs, DLX::Matrix const& rhs)
+{
+    if(lhs.getRowCount() != rhs.getRowCount()) { return false; }
+    std::vector<int> lhs_columns;
+    std::vector<int> rhs_columns;
+    for(int i=0; i<lhs.getRowCount(); ++i)
+    {
+        lhs.getRowColumns(i, lhs_columns);
+        rhs.getRowColumns(i, rhs_columns);
+        if(lhs_columns != rhs_columns || lhs.getRowHeader(i).UserData != rhs.getRowHeader(i).UserData) { return false; }
+    }
+    return true;
+}
+
+Polyomino::ProblemInstance<Shape>& addPieces(Polyomino::ProblemInstance<Shape>& problem)
+{
+    for(auto const s : { Shape::T, Shape::T, Shape::O, Shape::O, Shape::I, Shape::J, Shape::L, Shape::L, Shape::S })
+    {
+        problem.addPiece(s);
+    }
+    return problem;
+}
+
+void testRelayout()
+{
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    addPieces(problem);
+    int const n_columns = problem.getPieceColumnCount() + problem.getBoard().getOpenCellCount();
+    DLX::Matrix const m = problem.calculateProblemMatrix();
+    DLX::Matrix original = rebuildRows(m, n_columns);
+    DLX::Matrix relaid = rebuildRows(m, n_columns);
+    relaid.optimizeLayout(problem.getPieceColumnCount());
+
+    check(sameRows(original, relaid), "relayout keeps the row indices, columns and user data");
+    auto const expected = sortedSolutions(original);
+    check(!expected.empty() && sortedSolutions(relaid) == expected, "relayout keeps the solutions");
+
+    // a row selected after the relayout
+    auto const row = expected.front().front();
+    original.selectRow(row);
+    relaid.selectRow(row);
+    check(sortedSolutions(relaid) == sortedSolutions(original), "rows selected after the relayout");
+    original.unselectRow();
+    relaid.unselectRow();
+    check(sortedSolutions(relaid) == expected, "unselecting after the relayout restores all solutions");
+
+    // a row selected and a column deactivated before the relayout
+    DLX::Matrix selected = rebuildRows(m, n_columns);
+    selected.selectRow(row);
+    selected.deactivateColumn(n_columns - 1);
+    original.selectRow(row);
+    original.deactivateColumn(n_columns - 1);
+    selected.optimizeLayout(problem.getPieceColumnCount());
+    check(sameRows(original, selected), "relayout of a matrix with a selected row keeps the rows");
+    check(sortedSolutions(selected) == sortedSolutions(original), "relayout with a selected row and a deactivated column");
+    selected.reactivateColumns();
+    original.reactivateColumns();
+    selected.unselectRow();
+    original.unselectRow();
+    check(sortedSolutions(selected) == expected, "undoing the selection after the relayout restores all solutions");
+}
+
+void testFixedPlacements()
+{
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    addPieces(problem);
+    problem.addFixedPlacement(Polyomino::FixedPlacement<Shape>{ Shape::O, 0, 0, 0 });
+    problem.addFixedPlacement(Polyomino::FixedPlacement<Shape>{ Shape::I, 1, 5, 2 });
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    check(m.getSelectedRows().size() == 2, "fixed placements are selected");
+
+    // the same rows without relayout, with the fixed rows selected
+    DLX::Matrix original = rebuildRows(m, problem.getPieceColumnCount() + problem.getBoard().getOpenCellCount());
+    for(auto const row : m.getSelectedRows()) { original.selectRow(row); }
+    auto const expected = sortedSolutions(original);
+    check(!expected.empty() && sortedSolutions(m) == expected, "fixed placements selected after the relayout");
+    for(auto const row : m.getSelectedRows())
+    {
+        auto const shape = *static_cast<Shape const*>(m.getRowHeader(row).UserData);
+        check(shape == Shape::O || shape == Shape::I, "user data of a fixed row is its piece");
+    }
+}
+}
+
+int main()
+{
+    testRelayout();
+    testFixedPlacements();
+    if(failures == 0) { std::cout << "All layout tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/*! Cross-check of DLX::Matrix::preprocess() against the unreduced matrix.
+ *
+ * Solves every problem file, a surplus inventory and a raw exact cover matrix with and without preprocessing
+ * and compares the sets of solutions. Also checks that preprocessing detects instances without solutions.
+ *
+ * Usage:
+ *   preprocess_test <problems_dir> <matrix_file>
+ */
+#include <DLX.hpp>
+#include <matrix_file.hpp>
+#include <problem_file.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+/* Solutions with their rows sorted, in sorted order, so that solutions found in a different order compare equal.
+ */
+std::vector<DLX::Matrix::Solution> sortedSolutions(DLX::Matrix& m)
+{
+    auto ret = m.solveAll();
+    for(auto& s : ret) { std::sort(begin(s), end(s)); }
+    std::sort(begin(ret), end(ret));
+    return ret;
+}
+
+/* Preprocesses reduced, which must be a copy of original, and compares the solutions of both.
+ */
+void compare(std::string const& name, DLX::Matrix& original, DLX::Matrix& reduced)
+{
+    auto const statistics = reduced.preprocess();
+    auto const expected = sortedSolutions(original);
+    auto const actual = sortedSolutions(reduced);
+    check(actual == expected, name + ": preprocessing changes the solutions");
+    check(!statistics.infeasible || expected.empty(), name + ": preprocessing reports a solvable matrix as infeasible");
+    std::cout << name << ": " << expected.size() << " solutions, removed " << statistics.removedRows << " of "
+              << reduced.getRowCount() << " rows, " << statistics.forcedRows << " forced rows\n";
+}
+
+void testProblemFiles(std::filesystem::path const& dir)
+{
+    std::vector<std::filesystem::path> files;
+    for(auto const& entry : std::filesystem::directory_iterator(dir))
+    {
+        if(entry.is_regular_file() && entry.path().extension() == ".txt") { files.push_back(entry.path()); }
+    }
+    std::sort(begin(files), end(files));
+    check(!files.empty(), "problem files found in " + dir.string());
+
+    using Tetromino::OneSided::Shape;
+    for(auto const& f : files)
+    {
+        std::ifstream fin(f);
+        Tetromino::OneSided::ProblemDescription description;
+        if(!Tetromino::OneSided::readProblemDescription(fin, description)) {
+            check(false, "malformed problem file " + f.string());
+            continue;
+        }
+        Polyomino::ProblemInstance<Shape> problem(description.board);
+        Tetromino::OneSided::addPieces(problem, description);
+        DLX::Matrix original = problem.calculateProblemMatrix();
+        DLX::Matrix reduced = problem.calculateProblemMatrix();
+        compare(f.stem().string(), original, reduced);
+    }
+
+    // surplus inventories have secondary piece columns with multiplicities
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 4, 4 });
+    for(auto const s : { Shape::I, Shape::I, Shape::I, Shape::I, Shape::O, Shape::O, Shape::T, Shape::T })
+    {
+        problem.addPiece(s);
+    }
+    DLX::Matrix original = problem.calculateProblemMatrix();
+    DLX::Matrix reduced = problem.calculateProblemMatrix();
+    compare("4x4 IIIIOOTT", original, reduced);
+}
+
+void testMatrixFile(std::string const& filename)
+{
+    DLX::MatrixFile matrix_file;
+    std::string error;
+    if(!matrix_file.load(filename, error)) {
+        check(false, "matrix file " + filename + " could not be loaded: " + error);
+        return;
+    }
+    DLX::Matrix original = DLX::createMatrix(matrix_file.getMatrix());
+    DLX::Matrix reduced = DLX::createMatrix(matrix_file.getMatrix());
+    compare(std::filesystem::path(filename).stem().string(), original, reduced);
+}
+
+void testInfeasible()
+{
+    // column 0 forces row 0, which removes the only row of column 2
+    DLX::Matrix m(3);
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0, 1 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 1, 2 });
+    auto const statistics = m.preprocess();
+    check(statistics.infeasible, "forced row that empties a column is detected as infeasible");
+    check(statistics.forcedRows == 1, "the row of a single-row column is forced");
+    check(m.solveAll().empty(), "infeasible matrix has no solutions");
+
+    // the corner cells are cut off by blocked cells, so no piece covers them
+    using Tetromino::OneSided::Shape;
+    Polyomino::BoardMask board(Polyomino::FieldSize{ 4, 4 });
+    for(auto const& [x, y] : { std::make_pair(1, 0), std::make_pair(0, 1), std::make_pair(3, 2), std::make_pair(2, 3) })
+    {
+        board.blockCell(x, y);
+    }
+    Polyomino::ProblemInstance<Shape> problem(board);
+    for(auto const s : { Shape::I, Shape::O, Shape::T }) { problem.addPiece(s); }
+    DLX::Matrix pm = problem.calculateProblemMatrix();
+    check(pm.preprocess().infeasible, "board with uncoverable cells is detected as infeasible");
+    check(pm.solveAll().empty(), "board with uncoverable cells has no solutions");
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 3)
+    {
+        std::cout << "Usage: \n"
+                  << "  preprocess_test <problems_dir> <matrix_file>\n"
+                  << std::endl;
+        return 1;
+    }
+    testProblemFiles(argv[1]);
+    testMatrixFile(argv[2]);
+    testInfeasible();
+    if(failures == 0) { std::cout << "All preprocessing tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+/*! Tests for DLX::Matrix::solveUpTo() and Polyomino::PuzzleGenerator.
+ *
+ * Checks that solveUpTo() stops the search at the requested number of solutions, that the uniqueness check
+ * tells unique, ambiguous and unsolvable piece sets apart, and that generated puzzles pass the check.
+ *
+ * Usage:
+ *   puzzle_generator_test
+ */
+#include <DLX.hpp>
+#include <master_matrix.hpp>
+#include <problem_instance.hpp>
+#include <puzzle_generator.hpp>
+#include <tetromino.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Tetromino::OneSided::Shape;
+
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+void testSolveUpTo()
+{
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    for(auto const s : { Shape::T, Shape::T, Shape::O, Shape::O, Shape::I, Shape::J, Shape::L, Shape::L, Shape::S })
+    {
+        problem.addPiece(s);
+    }
+    DLX::Matrix all = problem.calculateProblemMatrix();
+    auto const solutions = all.solveAll();
+    auto const full_nodes = all.getStatistics().nodes;
+
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    auto const two = m.solveUpTo(2);
+    check(two.size() == 2, "solveUpTo(2) returns two solutions");
+    check(m.getStatistics().solutions == 2, "solveUpTo(2) stops the search at the second solution");
+    check(m.getStatistics().nodes < full_nodes, "solveUpTo(2) searches fewer nodes than solveAll()");
+    check(two.size() == 2 && two[0] == solutions[0] && two[1] == solutions[1],
+          "solveUpTo(2) returns the first two solutions of solveAll()");
+    check(m.solveUpTo(0).empty(), "solveUpTo(0) returns no solutions");
+    check(m.solveUpTo(solutions.size() + 1) == solutions, "solveUpTo() with a larger limit returns all solutions");
+
+    // the master matrix restores its state after a query that stopped early
+    auto& master = Polyomino::MasterMatrix<Shape>::getCached(Polyomino::FieldSize{ 4, 4 });
+    std::vector<Shape> const pieces = { Shape::I, Shape::I, Shape::O, Shape::O };
+    auto const master_solutions = master.solveAll(pieces);
+    check(master_solutions.size() > 2, "4x4 IIOO has more than two tilings");
+    check(master.solveUpTo(pieces, 2).size() == 2, "master matrix solveUpTo(2) returns two tilings");
+    check(master.solveAll(pieces) == master_solutions, "master matrix is restored after solveUpTo()");
+}
+
+void testUniqueness()
+{
+    typedef Polyomino::PuzzleGenerator<Shape> Generator;
+    Polyomino::FieldSize const square{ 4, 4 };
+    // rows and columns of I pieces are rotations of each other
+    check(Generator::hasUniqueSolution(square, { Shape::I, Shape::I, Shape::I, Shape::I }), "4x4 IIII is unique");
+    check(Generator::hasUniqueSolution(square, { Shape::O, Shape::O, Shape::O, Shape::O }), "4x4 OOOO is unique");
+    // the I pieces either side by side or around the O pieces
+    check(!Generator::hasUniqueSolution(square, { Shape::I, Shape::I, Shape::O, Shape::O }), "4x4 IIOO is ambiguous");
+    check(!Generator::hasUniqueSolution(square, { Shape::S, Shape::S, Shape::S, Shape::S }), "4x4 SSSS is unsolvable");
+
+    Generator generator(4, 6, 20240901);
+    auto const puzzles = generator.generate(5);
+    check(puzzles.size() == 5, "generator returns the requested number of puzzles");
+    for(auto const& p : puzzles)
+    {
+        check(Generator::hasUniqueSolution(p.fieldSize, p.pieces), "generated puzzle has a unique solution");
+        std::uint64_t tilings = 0;
+        auto& master = Polyomino::MasterMatrix<Shape>::getCached(p.fieldSize);
+        master.solveAll(p.pieces, [&tilings](DLX::Matrix::Solution const&) { ++tilings; return true; });
+        int const n_symmetries = (p.fieldSize.x == p.fieldSize.y) ? 8 : 4;
+        check(tilings >= 1 && tilings <= static_cast<std::uint64_t>(n_symmetries),
+              "generated puzzle has no more tilings than symmetries of the field");
+    }
+    auto const& statistics = generator.getStatistics();
+    check(statistics.candidates >= puzzles.size() + statistics.unsolvable + statistics.ambiguous,
+          "every candidate is counted");
+}
+}
+
+int main()
+{
+    testSolveUpTo();
+    testUniqueness();
+    if(failures == 0) { std::cout << "All puzzle generator tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
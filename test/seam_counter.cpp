@@ -0,0 +1,79 @@
+/*! Cross-check of Polyomino::SeamCounter against the tilings found by Polyomino::MasterMatrix.
+ *
+ * Counts the tilings of random piece multisets on a few fields for every horizontal and vertical seam
+ * and for one and several threads, and compares them with the number of solutions of the master matrix.
+ *
+ * Usage:
+ *   seam_counter_test
+ */
+#include <master_matrix.hpp>
+#include <seam_counter.hpp>
+#include <tetromino.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main()
+{
+    using Tetromino::OneSided::Shape;
+    struct { int x; int y; } const sizes[] = { {4, 4}, {4, 6}, {6, 4}, {2, 8}, {5, 4}, {6, 6} };
+    // std::minstd_rand without distributions, so that the multisets are the same on every platform
+    std::minstd_rand rng(20240613);
+    int failures = 0;
+    int checks = 0;
+    for(auto const& size : sizes)
+    {
+        Polyomino::FieldSize const field_size{ size.x, size.y };
+        int const n_pieces = (size.x * size.y) / Polyomino::Degree<Shape>::value;
+        // most random multisets have no tiling at all, so draw until there are a few that have one,
+        // and keep one that has none
+        int n_tileable = 0;
+        bool has_untileable = false;
+        for(int attempt=0; attempt<200 && (n_tileable < 3 || !has_untileable); ++attempt)
+        {
+            std::vector<Shape> pieces;
+            for(int i=0; i<n_pieces; ++i) { pieces.push_back(static_cast<Shape>(rng() % static_cast<int>(Shape::END))); }
+
+            std::uint64_t expected = 0;
+            Polyomino::MasterMatrix<Shape>::getCached(field_size).solveAll(pieces, [&expected](auto const&) {
+                ++expected;
+                return true;
+            });
+            if(expected > 0 && n_tileable < 3) {
+                ++n_tileable;
+            } else if(expected == 0 && !has_untileable) {
+                has_untileable = true;
+            } else {
+                continue;
+            }
+            for(int horizontal=0; horizontal<2; ++horizontal)
+            {
+                int const extent = horizontal ? size.y : size.x;
+                for(int position=1; position<extent; ++position)
+                {
+                    Polyomino::SeamCounter<Shape> counter(field_size, { horizontal != 0, position });
+                    for(int n_threads : { 1, 3 })
+                    {
+                        auto const n = counter.count(pieces, n_threads);
+                        ++checks;
+                        if(n != expected) {
+                            std::cout << "FAILED: " << size.x << "x" << size.y << " ";
+                            for(auto const s : pieces) { std::cout << s; }
+                            std::cout << ", " << (horizontal ? "row" : "column") << " seam at " << position << ", "
+                                      << n_threads << " threads: counted " << n << ", expected " << expected << '\n';
+                            ++failures;
+                        }
+                    }
+                }
+            }
+        }
+        if(n_tileable == 0) {
+            std::cout << "FAILED: no tileable multiset found for " << size.x << "x" << size.y << '\n';
+            ++failures;
+        }
+    }
+    std::cout << checks - failures << " of " << checks << " seam counts match." << std::endl;
+    return (failures == 0) ? 0 : 1;
+}
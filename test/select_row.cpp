@@ -0,0 +1,100 @@
+/*! Tests for DLX::Matrix::selectRow().
+ *
+ * Checks that rows conflicting with previous selections are rejected, including rows whose own column was
+ * covered by a selection, deactivated or used up to its multiplicity, and that a rejected selection leaves
+ * the matrix unchanged.
+ *
+ * Usage:
+ *   select_row_test
+ */
+#include <DLX.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+bool selectionThrows(DLX::Matrix& m, int row)
+{
+    try {
+        m.selectRow(row);
+    } catch(std::logic_error const&) {
+        return true;
+    }
+    return false;
+}
+
+void testSameRowTwice()
+{
+    // two rows through a single column
+    DLX::Matrix m(1);
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0 });
+    m.selectRow(0);
+    check(selectionThrows(m, 0), "selecting a one-column row twice throws");
+    check(selectionThrows(m, 1), "selecting another row through a covered column throws");
+    check(m.getSelectedRows().size() == 1, "rejected selections are not recorded");
+    check(m.solveAll().size() == 1, "matrix is unchanged by rejected selections");
+    m.unselectRow();
+    check(m.solveAll().size() == 2, "unselecting restores all solutions");
+}
+
+void testConflictingRows()
+{
+    DLX::Matrix m(3);
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0, 1 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 1, 2 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 2 });
+    m.selectRow(0);
+    check(selectionThrows(m, 1), "selecting a row that shares a column throws");
+    check(!selectionThrows(m, 2), "selecting a compatible row works");
+    check(m.solveAll().size() == 1, "selected rows form the only solution");
+}
+
+void testDeactivatedColumn()
+{
+    DLX::Matrix m(2);
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0 });
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 1 });
+    m.deactivateColumn(0);
+    check(selectionThrows(m, 0), "selecting a row through a deactivated column throws");
+    m.reactivateColumns();
+    check(!selectionThrows(m, 0), "selecting the row after reactivation works");
+}
+
+void testUsedUpMultiplicity()
+{
+    // column 0 may be used twice, columns 1 to 3 once
+    DLX::Matrix m(4);
+    for(int i=1; i<4; ++i) { m.addRow(DLX::RowHeader(), std::vector<int>{ 0, i }); }
+    m.addRow(DLX::RowHeader(), std::vector<int>{ 0 });
+    m.setColumnMultiplicity(0, 2);
+    m.selectRow(0);
+    m.selectRow(1);
+    check(selectionThrows(m, 2), "selecting a row through a used up column throws");
+    check(selectionThrows(m, 3), "selecting a one-column row through a used up column throws");
+    check(m.getSelectedRows().size() == 2, "rejected selections are not recorded");
+}
+}
+
+int main()
+{
+    testSameRowTwice();
+    testConflictingRows();
+    testDeactivatedColumn();
+    testUsedUpMultiplicity();
+    if(failures == 0) { std::cout << "All row selection tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+/*! Tests for DLX::SolutionStore.
+ *
+ * Checks the capacity check of the index type, that the stored solutions read back as the rows that were
+ * pushed, and that sortUnique() canonicalizes the store and removes duplicates.
+ *
+ * Usage:
+ *   solution_store_test
+ */
+#include <DLX.hpp>
+#include <problem_instance.hpp>
+#include <solution_store.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+template<typename Index_T>
+bool constructionThrows(int solution_length, int nRows)
+{
+    try {
+        DLX::SolutionStore<Index_T> store(solution_length, nRows);
+    } catch(std::logic_error const&) {
+        return true;
+    }
+    return false;
+}
+
+void testCapacity()
+{
+    // row indices run from 0 to nRows - 1, so 65536 rows are the most that fit into 16 bits
+    check(!constructionThrows<std::uint16_t>(3, 65536), "65536 rows fit into 16-bit indices");
+    check(constructionThrows<std::uint16_t>(3, 65537), "65537 rows do not fit into 16-bit indices");
+    check(!constructionThrows<std::uint32_t>(3, 65537), "65537 rows fit into 32-bit indices");
+    check(constructionThrows<std::uint16_t>(-1, 10), "negative solution length is rejected");
+
+    DLX::SolutionStore<> store(3, 10);
+    bool threw = false;
+    try {
+        store.push(DLX::Matrix::Solution{ 1, 2 });
+    } catch(std::logic_error const&) {
+        threw = true;
+    }
+    check(threw, "pushing a solution of the wrong length throws");
+    check(store.empty(), "rejected solution is not stored");
+}
+
+void testSpans()
+{
+    using namespace Tetromino::OneSided;
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    for(auto const s : { Shape::T, Shape::T, Shape::O, Shape::O, Shape::I, Shape::J, Shape::L, Shape::L, Shape::S })
+    {
+        problem.addPiece(s);
+    }
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    auto const expected = m.solveAll();
+    DLX::SolutionStore<> store(problem.getRequiredPieceCount(), m.getRowCount());
+    for(auto const& s : expected) { store.push(s); }
+
+    check(!expected.empty(), "problem has solutions");
+    check(store.size() == expected.size(), "store holds every pushed solution");
+    for(std::size_t i = 0; i < expected.size(); ++i)
+    {
+        auto const view = store[i];
+        check(std::equal(view.begin(), view.end(), expected[i].begin(), expected[i].end()),
+              "span of solution " + std::to_string(i) + " matches the pushed rows");
+        check(store.getSolution(i) == expected[i], "copy of solution " + std::to_string(i) + " matches the pushed rows");
+    }
+    std::size_t index = 0;
+    for(auto const view : store)
+    {
+        check(std::equal(view.begin(), view.end(), expected[index].begin(), expected[index].end()),
+              "iterated solution " + std::to_string(index) + " matches the pushed rows");
+        ++index;
+    }
+    check(index == expected.size(), "iteration visits every solution");
+    check(store.end() - store.begin() == static_cast<std::ptrdiff_t>(expected.size()), "iterator distance is the size");
+}
+
+void testSortUnique()
+{
+    DLX::SolutionStore<> store(3, 10);
+    store.push(DLX::Matrix::Solution{ 3, 1, 2 });
+    store.push(DLX::Matrix::Solution{ 4, 2, 1 });
+    store.push(DLX::Matrix::Solution{ 2, 3, 1 });      // the first solution in another order
+    store.push(DLX::Matrix::Solution{ 0, 5, 9 });
+    store.push(DLX::Matrix::Solution{ 1, 2, 3 });      // the first solution again
+    store.push(DLX::Matrix::Solution{ 1, 2, 4 });      // the second solution in sorted order
+    store.sortUnique();
+
+    std::vector<DLX::Matrix::Solution> const expected = { { 0, 5, 9 }, { 1, 2, 3 }, { 1, 2, 4 } };
+    check(store.size() == expected.size(), "sortUnique removes duplicate solutions");
+    for(std::size_t i = 0; i < std::min(store.size(), expected.size()); ++i)
+    {
+        check(store.getSolution(i) == expected[i], "solution " + std::to_string(i) + " is sorted and in order");
+    }
+
+    store.sortUnique();
+    check(store.size() == expected.size(), "sortUnique is idempotent");
+
+    DLX::SolutionStore<> empty_store(3, 10);
+    empty_store.sortUnique();
+    check(empty_store.empty(), "sortUnique on an empty store");
+}
+}
+
+int main()
+{
+    testCapacity();
+    testSpans();
+    testSortUnique();
+    if(failures == 0) { std::cout << "All solution store tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
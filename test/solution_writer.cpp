@@ -0,0 +1,260 @@
+/*! Round-trip tests for DLX::SolutionWriter and its formatters.
+ *
+ * Writes solutions with the ndjson, binary and grid formatters to a temporary file, parses the output
+ * and compares it with the pushed solutions and with the grids of Polyomino::SolutionRenderer.
+ *
+ * Usage:
+ *   solution_writer_test
+ */
+#include <DLX.hpp>
+#include <problem_instance.hpp>
+#include <solution_renderer.hpp>
+#include <solution_writer.hpp>
+#include <tetromino.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using Tetromino::OneSided::Shape;
+
+int failures = 0;
+
+void check(bool condition, std::string const& what)
+{
+    if(!condition) {
+        std::cout << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+/* Writes the solutions with the formatter and returns the contents of the output file.
+ */
+std::string write(std::unique_ptr<DLX::SolutionFormatter> formatter, std::vector<DLX::Matrix::Solution> const& solutions,
+                  int max_solution_length)
+{
+    std::FILE* out = std::tmpfile();
+    if(!out) {
+        check(false, "temporary file could not be created");
+        return std::string();
+    }
+    {
+        DLX::SolutionWriter writer(std::move(formatter), out, max_solution_length);
+        for(auto const& s : solutions) { writer.push(s); }
+        writer.finish();
+        check(writer.getSolutionCount() == solutions.size(), "writer counts the pushed solutions");
+    }
+    std::string ret;
+    std::rewind(out);
+    char buffer[4096];
+    std::size_t n;
+    while((n = std::fread(buffer, 1, sizeof(buffer), out)) > 0) { ret.append(buffer, n); }
+    std::fclose(out);
+    return ret;
+}
+
+std::vector<DLX::Matrix::Solution> randomSolutions(int count, int nRows, int max_solution_length, unsigned seed)
+{
+    std::minstd_rand rng(seed);
+    std::vector<DLX::Matrix::Solution> ret(count);
+    for(auto& s : ret)
+    {
+        s.resize(rng() % (max_solution_length + 1));
+        for(auto& row : s) { row = rng() % nRows; }
+    }
+    // the largest row index is always written
+    if(!ret.empty() && max_solution_length > 0) { ret.back().assign(1, nRows - 1); }
+    return ret;
+}
+
+/* Reads the comma-separated integers of the JSON array that starts at pos, which is advanced past its end.
+ */
+std::vector<int> parseIntArray(std::string const& line, std::size_t& pos)
+{
+    std::vector<int> ret;
+    if(line.compare(pos, 1, "[") != 0) { return ret; }
+    ++pos;
+    while(pos < line.size() && line[pos] != ']')
+    {
+        std::size_t length = 0;
+        ret.push_back(std::stoi(line.substr(pos), &length));
+        pos += length;
+        if(line[pos] == ',') { ++pos; }
+    }
+    ++pos;
+    return ret;
+}
+
+/* Parses one line of ndjson output into its solution index, rows and, if present, grid lines.
+ */
+bool parseNdjson(std::string const& line, std::uint64_t& index, std::vector<int>& rows, std::vector<std::string>& grid)
+{
+    std::string const solution_key = "{\"solution\":";
+    std::string const rows_key = ",\"rows\":";
+    std::string const grid_key = ",\"grid\":[";
+    if(line.compare(0, solution_key.size(), solution_key) != 0) { return false; }
+    std::size_t pos = solution_key.size();
+    std::size_t length = 0;
+    index = std::stoull(line.substr(pos), &length);
+    pos += length;
+    if(line.compare(pos, rows_key.size(), rows_key) != 0) { return false; }
+    pos += rows_key.size();
+    rows = parseIntArray(line, pos);
+    grid.clear();
+    if(line.compare(pos, grid_key.size(), grid_key) == 0) {
+        pos += grid_key.size();
+        while(pos < line.size() && line[pos] == '"')
+        {
+            auto const close = line.find('"', pos + 1);
+            if(close == std::string::npos) { return false; }
+            grid.push_back(line.substr(pos + 1, close - pos - 1));
+            pos = close + 1;
+            if(line[pos] == ',') { ++pos; }
+        }
+        if(line.compare(pos, 1, "]") != 0) { return false; }
+        ++pos;
+    }
+    return line.substr(pos) == "}";
+}
+
+std::vector<std::string> splitLines(std::string const& text)
+{
+    std::vector<std::string> ret;
+    std::istringstream iss(text);
+    std::string line;
+    while(std::getline(iss, line)) { ret.push_back(line); }
+    return ret;
+}
+
+void testNdjson()
+{
+    auto const solutions = randomSolutions(20000, 1000000, 12, 1);
+    auto const output = write(std::make_unique<DLX::NdjsonFormatter>(), solutions, 12);
+    check(output.empty() || output.back() == '\n', "ndjson output ends with a newline");
+    auto const lines = splitLines(output);
+    check(lines.size() == solutions.size(), "ndjson writes one line per solution");
+    bool parsed = true;
+    bool matches = true;
+    std::vector<int> rows;
+    std::vector<std::string> grid;
+    for(std::size_t i=0; i<lines.size() && i<solutions.size(); ++i)
+    {
+        std::uint64_t index = 0;
+        parsed = parsed && parseNdjson(lines[i], index, rows, grid) && grid.empty();
+        matches = matches && (index == i + 1) && (rows == solutions[i]);
+    }
+    check(parsed, "ndjson lines parse");
+    check(matches, "ndjson lines hold the solution index and rows");
+    check(write(std::make_unique<DLX::NdjsonFormatter>(), {}, 12).empty(), "ndjson output without solutions is empty");
+}
+
+template<typename T>
+T readValue(std::string const& data, std::size_t offset)
+{
+    T ret;
+    std::memcpy(&ret, data.data() + offset, sizeof(ret));
+    return ret;
+}
+
+void testBinary(int nRows, std::uint32_t expected_index_bytes)
+{
+    auto const name = "binary output for " + std::to_string(nRows) + " rows";
+    auto const solutions = randomSolutions(20000, nRows, 12, nRows);
+    auto const output = write(std::make_unique<DLX::BinaryFormatter>(nRows), solutions, 12);
+    if(output.size() < 16) {
+        check(false, name + ": header is present");
+        return;
+    }
+    check(output.compare(0, 8, "DLXSOL01") == 0, name + ": magic");
+    check(readValue<std::uint32_t>(output, 8) == static_cast<std::uint32_t>(nRows), name + ": row count");
+    auto const index_bytes = readValue<std::uint32_t>(output, 12);
+    check(index_bytes == expected_index_bytes, name + ": index size");
+
+    std::size_t pos = 16;
+    std::vector<DLX::Matrix::Solution> parsed;
+    while(pos + 4 <= output.size())
+    {
+        auto const n = readValue<std::uint32_t>(output, pos);
+        pos += 4;
+        if(pos + n * index_bytes > output.size()) { break; }
+        DLX::Matrix::Solution s(n);
+        for(auto& row : s)
+        {
+            row = (index_bytes == 2) ? readValue<std::uint16_t>(output, pos) : readValue<std::uint32_t>(output, pos);
+            pos += index_bytes;
+        }
+        parsed.push_back(s);
+    }
+    check(pos == output.size(), name + ": records fill the output");
+    check(parsed == solutions, name + ": records hold the solutions");
+    check(write(std::make_unique<DLX::BinaryFormatter>(nRows), {}, 12).size() == 16,
+          name + ": output without solutions is the header");
+}
+
+void testGrid()
+{
+    Polyomino::ProblemInstance<Shape> problem(Polyomino::FieldSize{ 6, 6 });
+    for(auto const s : { Shape::T, Shape::T, Shape::O, Shape::O, Shape::I, Shape::J, Shape::L, Shape::L, Shape::S })
+    {
+        problem.addPiece(s);
+    }
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    auto const solutions = m.solveAll();
+    check(!solutions.empty(), "6x6 problem has solutions");
+    int const max_solution_length = problem.getRequiredPieceCount();
+    auto const& board = problem.getBoard();
+    int const n_pieces = problem.getPieceColumnCount();
+    Polyomino::SolutionRenderer<Shape> renderer(board, n_pieces);
+
+    std::string expected;
+    for(std::size_t i=0; i<solutions.size(); ++i)
+    {
+        expected += "\n *** Solution #" + std::to_string(i + 1) + ": ***\n\n" + renderer.render(m, solutions[i]) + "\n";
+    }
+    auto const grid_output =
+        write(std::make_unique<Polyomino::GridFormatter<Shape>>(m, board, n_pieces), solutions, max_solution_length);
+    check(grid_output == expected, "grid output holds the rendered solutions");
+    check(write(std::make_unique<Polyomino::GridFormatter<Shape>>(m, board, n_pieces), {}, max_solution_length) ==
+              "No solution.\n",
+          "grid output without solutions");
+
+    auto const ndjson_output =
+        write(std::make_unique<Polyomino::NdjsonGridFormatter<Shape>>(m, board, n_pieces), solutions, max_solution_length);
+    auto const lines = splitLines(ndjson_output);
+    check(lines.size() == solutions.size(), "ndjson grid output writes one line per solution");
+    bool matches = true;
+    std::vector<int> rows;
+    std::vector<std::string> grid;
+    for(std::size_t i=0; i<lines.size() && i<solutions.size(); ++i)
+    {
+        std::uint64_t index = 0;
+        if(!parseNdjson(lines[i], index, rows, grid)) {
+            matches = false;
+            continue;
+        }
+        std::string rendered;
+        for(auto const& g : grid) { rendered += g + "\n"; }
+        matches = matches && (index == i + 1) && (rows == solutions[i]) && (rendered == renderer.render(m, solutions[i]));
+    }
+    check(matches, "ndjson grid lines hold the rows and the rendered grid");
+}
+}
+
+int main()
+{
+    testNdjson();
+    testBinary(100, 2);
+    testBinary(65536, 2);
+    testBinary(65537, 4);
+    testGrid();
+    if(failures == 0) { std::cout << "All solution writer tests passed." << std::endl; }
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/*! Deterministic performance regression harness.
+ *
+ * Solves a fixed corpus of problems (all files from problems/ plus a set of generated boards)
+ * and compares the work counters of the search against checked-in golden values.
+ * The test fails if any counter increased or if the number of solutions changed.
+ *
+ * Usage:
+ *   work_counters <problems_dir> <golden_file> [--update]
+ */
+#include <DLX.hpp>
+#include <problem_file.hpp>
+#include <problem_instance.hpp>
+#include <tetromino.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct CorpusEntry
+{
+    std::string name;
+    Tetromino::OneSided::ProblemDescription description;
+};
+
+std::vector<CorpusEntry> loadProblemsDirectory(std::filesystem::path const& dir)
+{
+    std::vector<std::filesystem::path> files;
+    for(auto const& entry : std::filesystem::directory_iterator(dir))
+    {
+        if(entry.is_regular_file() && entry.path().extension() == ".txt") { files.push_back(entry.path()); }
+    }
+    std::sort(begin(files), end(files));
+
+    std::vector<CorpusEntry> ret;
+    for(auto const& f : files)
+    {
+        std::ifstream fin(f);
+        CorpusEntry e;
+        e.name = f.stem().string();
+        if(!Tetromino::OneSided::readProblemDescription(fin, e.description)) {
+            std::cerr << "Malformed problem file: " << f << std::endl;
+            std::exit(1);
+        }
+        ret.push_back(std::move(e));
+    }
+    return ret;
+}
+
+/* The generated boards use std::minstd_rand, whose output sequence is fully specified by the standard,
+ * and avoid the distributions (which are not), so the corpus is identical on every platform.
+ */
+std::vector<CorpusEntry> generateBoards()
+{
+    using Tetromino::OneSided::Shape;
+    struct { int x; int y; } const sizes[] = { {4, 4}, {4, 5}, {5, 4}, {4, 6}, {6, 4}, {4, 7}, {8, 4}, {6, 6} };
+    std::minstd_rand rng(20240521);
+    std::vector<CorpusEntry> ret;
+    for(auto const& size : sizes)
+    {
+        CorpusEntry e;
+        e.description.fieldSize = Polyomino::FieldSize{ size.x, size.y };
+        e.description.board = Polyomino::BoardMask(e.description.fieldSize);
+        int const n_pieces = (size.x * size.y) / Polyomino::Degree<Shape>::value;
+        std::string letters;
+        for(int i=0; i<n_pieces; ++i)
+        {
+            auto const s = static_cast<Shape>(rng() % static_cast<int>(Shape::END));
+            e.description.pieces.push_back(s);
+            std::ostringstream oss;
+            oss << s;
+            letters += oss.str();
+        }
+        e.name = "gen_" + std::to_string(size.x) + "x" + std::to_string(size.y) + "_" + letters;
+        ret.push_back(std::move(e));
+    }
+    return ret;
+}
+
+DLX::SearchStatistics runEntry(CorpusEntry const& entry)
+{
+    using Tetromino::OneSided::Shape;
+    Polyomino::ProblemInstance<Shape> problem(entry.description.board);
+    Tetromino::OneSided::addPieces(problem, entry.description);
+    DLX::Matrix m = problem.calculateProblemMatrix();
+    m.solveAll();
+    return m.getStatistics();
+}
+
+std::map<std::string, DLX::SearchStatistics> readGolden(std::string const& filename)
+{
+    std::map<std::string, DLX::SearchStatistics> ret;
+    std::ifstream fin(filename);
+    std::string line;
+    while(std::getline(fin, line))
+    {
+        if(line.empty() || line[0] == '#') { continue; }
+        std::istringstream iss(line);
+        std::string name;
+        DLX::SearchStatistics s;
+        if(!(iss >> name >> s.nodes >> s.linkUpdates >> s.solutions)) {
+            std::cerr << "Malformed line in golden file: " << line << std::endl;
+            std::exit(1);
+        }
+        ret[name] = s;
+    }
+    return ret;
+}
+
+void writeGolden(std::string const& filename, std::vector<std::pair<std::string, DLX::SearchStatistics>> const& results)
+{
+    std::ofstream fout(filename);
+    fout << "# name nodes link_updates solutions\n";
+    for(auto const& [name, s] : results)
+    {
+        fout << name << ' ' << s.nodes << ' ' << s.linkUpdates << ' ' << s.solutions << '\n';
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc != 3 && !(argc == 4 && std::string(argv[3]) == "--update"))
+    {
+        std::cout << "Usage: \n"
+                  << "  work_counters <problems_dir> <golden_file> [--update]\n"
+                  << std::endl;
+        return 1;
+    }
+    std::string const golden_file = argv[2];
+    bool const update = (argc == 4);
+
+    auto corpus = loadProblemsDirectory(argv[1]);
+    auto generated = generateBoards();
+    corpus.insert(end(corpus), begin(generated), end(generated));
+
+    std::vector<std::pair<std::string, DLX::SearchStatistics>> results;
+    for(auto const& entry : corpus)
+    {
+        results.emplace_back(entry.name, runEntry(entry));
+    }
+
+    if(update) {
+        writeGolden(golden_file, results);
+        std::cout << "Golden values written to " << golden_file << std::endl;
+        return 0;
+    }
+
+    auto const golden = readGolden(golden_file);
+    bool failed = false;
+    for(auto const& [name, s] : results)
+    {
+        std::cout << name << ": nodes " << s.nodes << ", link updates " << s.linkUpdates
+                  << ", solutions " << s.solutions;
+        auto it = golden.find(name);
+        if(it == golden.end()) {
+            std::cout << " - MISSING golden value\n";
+            failed = true;
+            continue;
+        }
+        auto const& g = it->second;
+        if(s.solutions != g.solutions) {
+            std::cout << " - FAILED: expected " << g.solutions << " solutions\n";
+            failed = true;
+        } else if(s.nodes > g.nodes || s.linkUpdates > g.linkUpdates) {
+            std::cout << " - FAILED: regression against golden nodes " << g.nodes
+                      << ", link updates " << g.linkUpdates << '\n';
+            failed = true;
+        } else if(s.nodes < g.nodes || s.linkUpdates < g.linkUpdates) {
+            std::cout << " - improved over golden nodes " << g.nodes << ", link updates " << g.linkUpdates
+                      << " (rerun with --update to tighten)\n";
+        } else {
+            std::cout << " - ok\n";
+        }
+    }
+    std::cout << std::flush;
+    return failed ? 1 : 0;
+}
@@ -2,6 +2,7 @@
 
 #include <polyomino.hpp>
 
+#include <array>
 #include <iosfwd>
 
 namespace Tetromino
@@ -54,13 +55,26 @@ namespace Tetromino
             return (s == Shape::END) ? Shape::END : static_cast<Shape>(static_cast<int>(s) + 1);
         }
 
-        inline int getRotations(Shape const& s)
+        inline constexpr std::array<Polyomino::OrientationSet<Shape>, static_cast<int>(Shape::END)> placementTable = {
+            Polyomino::generateOrientations<Shape>("####", Polyomino::Symmetry::OneSided),          // I
+            Polyomino::generateOrientations<Shape>("##/##", Polyomino::Symmetry::OneSided),         // O
+            Polyomino::generateOrientations<Shape>(".#./###", Polyomino::Symmetry::OneSided),       // T
+            Polyomino::generateOrientations<Shape>(".#/.#/##", Polyomino::Symmetry::OneSided),      // J
+            Polyomino::generateOrientations<Shape>("#./#./##", Polyomino::Symmetry::OneSided),      // L
+            Polyomino::generateOrientations<Shape>(".##/##.", Polyomino::Symmetry::OneSided),       // S
+            Polyomino::generateOrientations<Shape>("##./.##", Polyomino::Symmetry::OneSided)        // Z
+        };
+
+        constexpr int getRotations(Shape const& s)
         {
-            static const int rotations[] ={ 2 /* I */, 1 /* O */, 4 /* T */, 4 /* J */,
-                                            4 /* L */, 2 /* S */, 2 /* Z */ };
-            return rotations[static_cast<int>(s)];
+            return placementTable[static_cast<int>(s)].count;
         }
 
-        Placement getPlacement(Shape s, int rotation);
+        constexpr Placement const& getPlacement(Shape s, int rotation)
+        {
+            auto const& orientations = placementTable[static_cast<int>(s)];
+            if(rotation < 0 || rotation >= orientations.count) { PROTOCOL_VIOLATION("Invalid rotation"); }
+            return orientations.orientations[rotation];
+        }
     }
 }